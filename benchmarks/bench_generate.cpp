@@ -0,0 +1,76 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <date_wrapper/parallel.h>
+
+#include <thread>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Every minute of a year
+const DateTime start{Date{Year{2019}, Month{1}, Day{1}}};
+const DateTimeRange minutes{start, start + 24h * 365 - 1min};
+
+void bench_repeated_addition(benchmark::State& state)
+{
+    std::vector<DateTime> out(series_size(minutes, 1min), start);
+    for (auto _ : state) {
+        DateTime value{start};
+        for (auto& element : out) {
+            element = value;
+            value = value + 1min;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(out.size()));
+}
+
+void bench_generate(benchmark::State& state)
+{
+    std::vector<DateTime> out(series_size(minutes, 1min), start);
+    const auto concurrency = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        generate(minutes, 1min, span<DateTime>{out}, concurrency);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(out.size()));
+}
+
+void scaling(benchmark::internal::Benchmark* bench)
+{
+    const auto cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+        bench->Arg(threads);
+    bench->Arg(cores);
+    bench->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK(bench_repeated_addition);
+BENCHMARK(bench_generate)->Apply(scaling);
@@ -0,0 +1,75 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <date_wrapper/histogram.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace dw;
+
+namespace {
+
+std::vector<DateTime> make_events(std::size_t count)
+{
+    using namespace std::chrono;
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<long long> offset{0, 10LL * 365 * 86400};
+    const DateTime start{Date{Year{2010}, Month{1}, Day{1}}};
+    std::vector<DateTime> events;
+    events.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        events.push_back(start + seconds{offset(gen)});
+    return events;
+}
+
+const DateRange range{Date{Year{2010}, Month{1}, Day{1}},
+                      Date{Year{2019}, Month{12}, Day{31}}};
+
+void bench_histogram(benchmark::State& state, BucketUnit unit)
+{
+    static const auto events = make_events(4'000'000);
+    const auto concurrency = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        auto histogram = make_histogram(events, range, unit, concurrency);
+        benchmark::DoNotOptimize(histogram.values().data());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(events.size()));
+}
+
+void scaling(benchmark::internal::Benchmark* bench)
+{
+    const auto cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+        bench->Arg(threads);
+    bench->Arg(cores);
+    bench->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(bench_histogram, day, BucketUnit::Day)->Apply(scaling);
+BENCHMARK_CAPTURE(bench_histogram, iso_week, BucketUnit::IsoWeek)
+    ->Apply(scaling);
+BENCHMARK_CAPTURE(bench_histogram, month, BucketUnit::Month)->Apply(scaling);
@@ -0,0 +1,99 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <date_wrapper/search.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace dw;
+
+namespace {
+
+std::vector<DateTime> make_sorted(std::size_t count)
+{
+    using namespace std::chrono;
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<long long> offset{0, 10LL * 365 * 86400};
+    const DateTime start{Date{Year{2010}, Month{1}, Day{1}}};
+    std::vector<DateTime> values;
+    values.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        values.push_back(start + seconds{offset(gen)});
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+const std::vector<DateTime>& probes()
+{
+    static const auto result = [] {
+        auto values = make_sorted(1 << 16);
+        std::shuffle(values.begin(), values.end(), std::mt19937_64{7});
+        return values;
+    }();
+    return result;
+}
+
+void bench_std_lower_bound(benchmark::State& state)
+{
+    const auto values = make_sorted(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (const auto& probe : probes()) {
+            benchmark::DoNotOptimize(
+                std::lower_bound(values.begin(), values.end(), probe));
+        }
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(probes().size()));
+}
+
+void bench_index_lower_bound(benchmark::State& state)
+{
+    const auto values = make_sorted(static_cast<std::size_t>(state.range(0)));
+    const DateTimeIndex index{values};
+    for (auto _ : state) {
+        for (const auto& probe : probes())
+            benchmark::DoNotOptimize(index.lower_bound(probe));
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(probes().size()));
+}
+
+void bench_index_batch_lower_bound(benchmark::State& state)
+{
+    const auto values = make_sorted(static_cast<std::size_t>(state.range(0)));
+    const DateTimeIndex index{values};
+    std::vector<std::size_t> positions(probes().size());
+    for (auto _ : state) {
+        index.lower_bound(probes(), positions);
+        benchmark::DoNotOptimize(positions.data());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(probes().size()));
+}
+
+} // namespace
+
+BENCHMARK(bench_std_lower_bound)->Range(1 << 10, 1 << 24);
+BENCHMARK(bench_index_lower_bound)->Range(1 << 10, 1 << 24);
+BENCHMARK(bench_index_batch_lower_bound)->Range(1 << 10, 1 << 24);
@@ -0,0 +1,102 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <date_wrapper/date_wrapper.h>
+
+#include <sstream>
+#include <vector>
+
+using namespace dw;
+
+namespace {
+
+/* Stream insertion as it was implemented with iomanip manipulators, kept as
+ * a baseline. */
+void legacy_insert(std::ostream& os, const DateTime& dt)
+{
+    os << std::setfill('0') << std::setw(2) << static_cast<unsigned>(dt.day())
+       << "." << std::setfill('0') << std::setw(2)
+       << static_cast<unsigned>(dt.month()) << "."
+       << static_cast<int>(dt.year()) << " " << std::setfill('0')
+       << std::setw(2) << dt.hour().count() << ":" << std::setfill('0')
+       << std::setw(2) << dt.minute().count() << ":" << std::setfill('0')
+       << std::setw(2) << dt.second().count();
+}
+
+std::vector<DateTime> make_timestamps(std::size_t count)
+{
+    const DateTime start{Date{Year{2019}, Month{1}, Day{1}}};
+    std::vector<DateTime> timestamps;
+    timestamps.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        timestamps.push_back(start
+                             + std::chrono::seconds{
+                                 static_cast<long long>(i) * 7919});
+    return timestamps;
+}
+
+const std::vector<DateTime> timestamps = make_timestamps(1024);
+
+void bench_legacy_date_time_insertion(benchmark::State& state)
+{
+    std::ostringstream os;
+    for (auto _ : state) {
+        os.str({});
+        for (const auto& dt : timestamps)
+            legacy_insert(os, dt);
+        benchmark::DoNotOptimize(os.tellp());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(timestamps.size()));
+}
+
+void bench_date_time_insertion(benchmark::State& state)
+{
+    std::ostringstream os;
+    for (auto _ : state) {
+        os.str({});
+        for (const auto& dt : timestamps)
+            os << dt;
+        benchmark::DoNotOptimize(os.tellp());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(timestamps.size()));
+}
+
+void bench_date_time_range_insertion(benchmark::State& state)
+{
+    std::ostringstream os;
+    for (auto _ : state) {
+        os.str({});
+        for (std::size_t i = 1; i < timestamps.size(); ++i)
+            os << DateTimeRange{timestamps[i - 1], timestamps[i]};
+        benchmark::DoNotOptimize(os.tellp());
+    }
+    state.SetItemsProcessed(state.iterations()
+                            * static_cast<int64_t>(timestamps.size() - 1));
+}
+
+} // namespace
+
+BENCHMARK(bench_legacy_date_time_insertion);
+BENCHMARK(bench_date_time_insertion);
+BENCHMARK(bench_date_time_range_insertion);
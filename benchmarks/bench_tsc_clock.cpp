@@ -0,0 +1,62 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <date_wrapper/tsc_clock.h>
+
+#include <chrono>
+
+using namespace dw;
+
+namespace {
+
+void bench_system_clock_now(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::chrono::system_clock::now());
+}
+
+void bench_tsc_clock_now(benchmark::State& state)
+{
+    TscClock clock;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(clock.now());
+}
+
+void bench_current_date_time(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(current_date_time());
+}
+
+void bench_tsc_current_date_time(benchmark::State& state)
+{
+    TscClock clock;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(current_date_time(clock));
+}
+
+} // namespace
+
+BENCHMARK(bench_system_clock_now);
+BENCHMARK(bench_tsc_clock_now);
+BENCHMARK(bench_current_date_time);
+BENCHMARK(bench_tsc_current_date_time);
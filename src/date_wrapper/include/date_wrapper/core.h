@@ -0,0 +1,1639 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef CORE_H_R7QK2M4D
+#define CORE_H_R7QK2M4D
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+#include "instrumentation.h"
+#include "span.h"
+#include <date/date.h>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+/* Non-template functions that can't be constexpr are defined inline in the
+ * headers by default. Targets that link date_wrapper_impl get
+ * DATE_WRAPPER_COMPILED and see only declarations of these functions, which
+ * date_wrapper_impl compiles once with DATE_WRAPPER_IMPL defined. */
+#if defined(DATE_WRAPPER_IMPL)
+#define DW_OUT_OF_LINE
+#define DW_DEFINE_OUT_OF_LINE 1
+#elif defined(DATE_WRAPPER_COMPILED)
+#define DW_DEFINE_OUT_OF_LINE 0
+#else
+#define DW_OUT_OF_LINE inline
+#define DW_DEFINE_OUT_OF_LINE 1
+#endif
+
+namespace dw {
+
+using Days = date::days;
+using Weeks = date::weeks;
+using Months = date::months;
+using Years = date::years;
+using sys_days = date::sys_days;
+
+enum class Weekday {
+    Monday,
+    Tuesday,
+    Wednesday,
+    Thursday,
+    Friday,
+    Saturday,
+    Sunday
+};
+
+struct Year {
+    explicit constexpr Year(int year) noexcept;
+
+    explicit constexpr operator int() const noexcept;
+
+private:
+    date::year year_;
+};
+
+constexpr bool operator==(const Year& lhs, const Year& rhs) noexcept;
+
+constexpr bool operator!=(const Year& lhs, const Year& rhs) noexcept;
+
+struct Month {
+    explicit constexpr Month(unsigned month) noexcept;
+
+    explicit constexpr operator unsigned() const noexcept;
+
+private:
+    date::month month_;
+};
+
+constexpr bool operator==(const Month& lhs, const Month& rhs) noexcept;
+
+constexpr bool operator!=(const Month& lhs, const Month& rhs) noexcept;
+
+struct Day {
+    explicit constexpr Day(unsigned day) noexcept;
+
+    explicit constexpr operator unsigned() const noexcept;
+
+private:
+    date::day day_;
+};
+
+constexpr bool operator==(const Day& lhs, const Day& rhs) noexcept;
+
+constexpr bool operator!=(const Day& lhs, const Day& rhs) noexcept;
+
+class Date {
+public:
+    constexpr Date(Year year, Month month, Day day) noexcept;
+
+    constexpr Year year() const noexcept;
+
+    constexpr Month month() const noexcept;
+
+    constexpr Day day() const noexcept;
+
+    constexpr bool valid() const noexcept;
+
+    constexpr operator sys_days() const noexcept;
+
+private:
+    date::year_month_day ymd_;
+};
+
+constexpr Weekday weekday(const Date& date) noexcept;
+
+/* Returns first Date before current Date that has target Weekday
+ * or the same Date if it already has the target Weekday. */
+constexpr Date prev_weekday(const Date& date, Weekday target) noexcept;
+
+/* Returns first Date before current Date that has target Weekday,
+ * even if current date already has target Weekday. */
+constexpr Date prev_weekday_excluding_current(const Date& date,
+                                              Weekday target) noexcept;
+
+/* Returns first Date after current Date that has target Weekday or
+ * the same Date if it already has the target Weekday. */
+constexpr Date next_weekday(const Date& date, Weekday target) noexcept;
+
+/* Returns first Date after current Date that has target Weekday,
+ * even if current date already has target Weekday. */
+constexpr Date next_weekday_excluding_current(const Date& date,
+                                              Weekday target) noexcept;
+
+/* Returns Date that corresponds to the last day of month for the current
+ * Date. */
+constexpr Date last_day_of_month(const Date& date) noexcept;
+
+/* Returns current date UTC */
+Date current_date() noexcept;
+
+/* Returns current date for local time zone.
+ * NOTE: Not thread-safe */
+Date current_date_local() noexcept;
+
+/* Returns new Date with days.count() days added to it. */
+constexpr Date operator+(const Date& date, const Days& days) noexcept;
+
+/* Returns new Date with days.count() subracted from it.
+ * Equivalent to date + -days. */
+constexpr Date operator-(const Date& date, const Days& days) noexcept;
+
+/* Returns new Date with 7 * weeks.count() days added to it. */
+constexpr Date operator+(const Date& date, const Weeks& weeks) noexcept;
+
+/* Returns new Date with 7 * weeks.count() days subtracted from it.
+ * Equivalent to date + -weeks. */
+constexpr Date operator-(const Date& date, const Weeks& weeks) noexcept;
+
+/* Returns new Date with months.count() added to it. The result has the
+ * same day number as original date. Note that resulting date might not
+ * represent a valid date if date.day() is 29, 30 or 31. In that case the
+ * latest valid date is returned. */
+constexpr Date operator+(const Date& date, const Months& months) noexcept;
+
+/* Returns new Date with months.count() subtracted from it. The result has the
+ * same day number as original date. Note that resulting date might not
+ * represent a valid date if date.day() is 29, 30 or 31. In that case the latest
+ * valid date is returned.
+ *
+ * Equivalent to date + -months. */
+constexpr Date operator-(const Date& date, const Months& months) noexcept;
+
+/* Returns new Date with years.count() added to it. The result has the
+ * same month and day number as original date. Note that resulting date might
+ * not represent a valid date if date.day() is 29, 30 or 31. In that case the
+ * latest valid date is returned. */
+constexpr Date operator+(const Date& date, const Years& years) noexcept;
+
+/* Returns new Date with years.count() subtracted from it. The result has the
+ * same month and day number as original date. Note that resulting date might
+ * not represent a valid date if date.day() is 29, 30 or 31. In that case the
+ * latest valid date is returned.
+ *
+ * Equivalent to date + -years. */
+constexpr Date operator-(const Date& date, const Years& years) noexcept;
+
+/* Returns "normalized" date when date is invalid, otherwise returns the same
+ date.
+ *
+ * Date is "normalized" as follows:
+ * If date.month() is 0, this will subtract one from the year and set the month
+ * to Dec. If date.month() is greater than 12, the year will be incremented as
+ many
+ * times as appropriate, and the month will be brought within the proper range.
+ * After month is "normalized" day field is brought withing the proper range:
+ * i.e. 2015.12.32 becomes 2016.01.01
+ *
+ * This function can be used to 'normalize' any invalid Date, i.e.
+ * 2015.55.250 becomes 2020.03.06.
+ */
+constexpr Date normalize(const Date& date) noexcept;
+
+constexpr bool operator==(const Date& lhs, const Date& rhs) noexcept;
+
+constexpr bool operator!=(const Date& lhs, const Date& rhs) noexcept;
+
+constexpr bool operator<=(const Date& lhs, const Date& rhs) noexcept;
+
+constexpr bool operator<(const Date& lhs, const Date& rhs) noexcept;
+
+constexpr bool operator>=(const Date& lhs, const Date& rhs) noexcept;
+
+constexpr bool operator>(const Date& lhs, const Date& rhs) noexcept;
+
+namespace utils {
+
+template <typename T> struct is_chrono_duration {
+    static constexpr bool value = false;
+};
+
+template <typename Rep, typename Period>
+struct is_chrono_duration<std::chrono::duration<Rep, Period>> {
+    static constexpr bool value = true;
+};
+
+template <class Duration, class Rep, class Period>
+Duration checked_convert(std::chrono::duration<Rep, Period> d);
+
+/* Narrowest integer that holds any time of day counted in Duration ticks;
+ * floating-point durations keep their own representation. */
+template <typename Duration,
+          bool = std::chrono::treat_as_floating_point<
+              typename Duration::rep>::value>
+struct time_of_day_storage {
+    using type = typename Duration::rep;
+};
+
+template <typename Duration> struct time_of_day_storage<Duration, false> {
+    using type = std::conditional_t<
+        (Days{1} <= std::chrono::duration<std::uint32_t,
+                                          typename Duration::period>::max()),
+        std::uint32_t,
+        typename Duration::rep>;
+};
+
+} // namespace utils
+
+/* Immutable datatype that stores date and time of day with Duration
+ * precision.
+ *
+ * Value is kept as days since epoch plus ticks since midnight; calendar
+ * fields are derived on access. Precisions that fit a day into 32 bits
+ * (seconds, milliseconds) make values half the size of DateTime.
+ * Time that is finer than precision is truncated towards the beginning of
+ * time.
+ */
+template <typename Duration> class BasicDateTime {
+public:
+    static_assert(utils::is_chrono_duration<Duration>::value,
+                  "precision must be a std::chrono::duration");
+
+    using precision = Duration;
+
+    template <typename Clock, typename TimePointDuration>
+    constexpr explicit BasicDateTime(
+        const std::chrono::time_point<Clock, TimePointDuration>&
+            timepoint) noexcept;
+
+    constexpr explicit BasicDateTime(const Date& date) noexcept;
+
+    template <typename Rep, typename Period>
+    constexpr BasicDateTime(
+        const Date& date,
+        const std::chrono::duration<Rep, Period>& time_since_midnight) noexcept;
+
+    /* Converts from other precision. Throws std::overflow_error if time of
+     * day can't be represented with this precision. */
+    template <typename OtherDuration>
+    explicit BasicDateTime(const BasicDateTime<OtherDuration>& other);
+
+    constexpr Date date() const noexcept;
+
+    /* Returns date as days since epoch, cheaper than date(). */
+    constexpr sys_days day_point() const noexcept;
+
+    constexpr Year year() const noexcept;
+
+    constexpr Month month() const noexcept;
+
+    constexpr Day day() const noexcept;
+
+    constexpr precision time() const noexcept;
+
+    /* Return hours since midnight in 24-h format. */
+    constexpr std::chrono::hours hour() const noexcept;
+
+    /* Return minutes since the start of the hour. */
+    constexpr std::chrono::minutes minute() const noexcept;
+
+    /* Return seconds since the start of the minute. */
+    constexpr std::chrono::seconds second() const noexcept;
+
+    /* Return day of week. */
+    constexpr Weekday weekday() const noexcept;
+
+private:
+    using time_storage = typename utils::time_of_day_storage<Duration>::type;
+
+    constexpr BasicDateTime(sys_days day_point, Duration time) noexcept;
+
+    constexpr date::year_month_day ymd() const noexcept;
+
+    /* 32-bit day count covers every year date::year can hold. */
+    std::chrono::duration<std::int32_t, Days::period> days_;
+    time_storage time_;
+};
+
+using DateTime = BasicDateTime<std::chrono::system_clock::duration>;
+
+/* Returns current DateTime using std::chrono::system_clock. */
+DateTime current_date_time() noexcept;
+
+/* Note: might not be thread-safe. */
+DateTime current_date_time_local() noexcept;
+
+/* Returns time point with specified resolution.
+ *
+ * Note, that using coarse resolution will lead to truncation loss.
+ *
+ * Also note, that when dealing with very fine resolution or very large date,
+ * special care needs to be taken, as these cases are subject to
+ * potential overflow error; in other words, user must be sure that requested
+ * duration is able to hold the desired value.
+ */
+template <typename ToDuration,
+          typename Clock = std::chrono::system_clock,
+          typename Duration = typename Clock::duration,
+          typename Precision>
+constexpr std::chrono::time_point<Clock, ToDuration>
+to_time_point(const BasicDateTime<Precision>& dt) noexcept;
+
+template <typename Duration>
+constexpr bool operator==(const BasicDateTime<Duration>& lhs,
+                          const BasicDateTime<Duration>& rhs) noexcept;
+
+template <typename Duration>
+constexpr bool operator!=(const BasicDateTime<Duration>& lhs,
+                          const BasicDateTime<Duration>& rhs) noexcept;
+
+template <typename Duration>
+constexpr bool operator<(const BasicDateTime<Duration>& lhs,
+                         const BasicDateTime<Duration>& rhs) noexcept;
+
+template <typename Duration>
+constexpr bool operator<=(const BasicDateTime<Duration>& lhs,
+                          const BasicDateTime<Duration>& rhs) noexcept;
+
+template <typename Duration>
+constexpr bool operator>(const BasicDateTime<Duration>& lhs,
+                         const BasicDateTime<Duration>& rhs) noexcept;
+
+template <typename Duration>
+constexpr bool operator>=(const BasicDateTime<Duration>& lhs,
+                          const BasicDateTime<Duration>& rhs) noexcept;
+
+/* Return new DateTime object that stands apart in time by given duration.
+ *
+ * Note that there are two ways to deal with date and time computations -
+ * chronological and calendrical.
+ * Chronological computation deals with regular time intervals (say, hours,
+ * days, average month length) while calendrical computation tries to
+ * preserve time of day and day of month when modifying date and time.
+ *
+ * This operator performes calendric computations.
+ *
+ * In case when adding duration will result in invalid date, DateTime that
+ * has the latest valid date will be returned,
+ * i.e. (31.02.2019) -> * (28.02.2019).
+ *
+ * Result has the same precision as dt, finer part of duration is truncated.
+ */
+template <typename Duration, typename Rep, typename Period>
+constexpr BasicDateTime<Duration>
+operator+(const BasicDateTime<Duration>& dt,
+          const std::chrono::duration<Rep, Period>& duration) noexcept;
+
+template <typename Duration, typename Rep, typename Period>
+constexpr BasicDateTime<Duration>
+operator-(const BasicDateTime<Duration>& dt,
+          const std::chrono::duration<Rep, Period>& duration) noexcept;
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>
+operator+(const BasicDateTime<Duration>& dt, const Months& months) noexcept;
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>
+operator-(const BasicDateTime<Duration>& dt, const Months& months) noexcept;
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>
+operator+(const BasicDateTime<Duration>& dt, const Years& years) noexcept;
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>
+operator-(const BasicDateTime<Duration>& dt, const Years& years) noexcept;
+
+/* Date in ISO 8601 week calendar: week-numbering year, week number and
+ * day of week.
+ *
+ * Value is packed into 32 bits, and packed() values order the same way as
+ * the dates they represent. Default constructed IsoDate is 1970-W01-4, that
+ * is 1970-01-01.
+ */
+class IsoDate {
+public:
+    constexpr IsoDate() noexcept;
+
+    template <typename Clock, typename Duration>
+    constexpr IsoDate(
+        const std::chrono::time_point<Clock, Duration>& time_point) noexcept;
+
+    template <typename Duration>
+    constexpr IsoDate(const BasicDateTime<Duration>& dt) noexcept;
+
+    constexpr IsoDate(const Date& date) noexcept;
+
+    /* Weeknum is expected to be in [1, 52] or [1, 53] depending on the year.
+     */
+    constexpr IsoDate(Year year, unsigned weeknum, Weekday weekday) noexcept;
+
+    /* Returns IsoDate of the day that is serial_day days after 1970-01-01. */
+    static constexpr IsoDate from_serial_day(long long serial_day) noexcept;
+
+    static constexpr IsoDate from_packed(std::int32_t packed) noexcept;
+
+    constexpr unsigned weeknum() const noexcept;
+
+    constexpr Year year() const noexcept;
+
+    constexpr Weekday weekday() const noexcept;
+
+    /* Returns year * 100 + weeknum, e.g. 201919 for 2019-W19. */
+    constexpr std::int32_t week_key() const noexcept;
+
+    /* Returns calendar date of this day. */
+    constexpr Date date() const noexcept;
+
+    constexpr std::int32_t packed() const noexcept;
+
+private:
+    // year << 9 | weeknum << 3 | ISO weekday in [1, 7]
+    std::int32_t packed_;
+
+    struct Packed {};
+
+    constexpr IsoDate(Packed, std::int32_t packed) noexcept;
+};
+
+constexpr bool operator==(const IsoDate& lhs, const IsoDate& rhs) noexcept;
+
+constexpr bool operator!=(const IsoDate& lhs, const IsoDate& rhs) noexcept;
+
+constexpr bool operator<(const IsoDate& lhs, const IsoDate& rhs) noexcept;
+
+constexpr bool operator>(const IsoDate& lhs, const IsoDate& rhs) noexcept;
+
+constexpr bool operator<=(const IsoDate& lhs, const IsoDate& rhs) noexcept;
+
+constexpr bool operator>=(const IsoDate& lhs, const IsoDate& rhs) noexcept;
+
+/* Converts dates to IsoDate::week_key(). Throws std::invalid_argument if
+ * sizes differ. */
+void to_iso_week_keys(span<const Date> dates, span<std::int32_t> keys);
+
+/* Converts dates to IsoDates. Throws std::invalid_argument if sizes differ.
+ */
+void to_iso_dates(span<const Date> dates, span<IsoDate> iso_dates);
+
+/* Time of day with millisecond precision, packed into 32 bits.
+ *
+ * Arithmetic wraps around midnight, so 23:30 + 1h is 00:30 and 00:30 - 1h is
+ * 23:30. Default constructed TimeOfDay is midnight. Combine with a Date into
+ * DateTime with operator+(const Date&, const TimeOfDay&).
+ */
+class TimeOfDay {
+public:
+    constexpr TimeOfDay() noexcept;
+
+    /* Duration since midnight is wrapped into [0, 24h) and truncated to
+     * milliseconds. */
+    template <typename Rep, typename Period>
+    constexpr explicit TimeOfDay(
+        const std::chrono::duration<Rep, Period>& since_midnight) noexcept;
+
+    constexpr TimeOfDay(std::chrono::hours hour,
+                        std::chrono::minutes minute,
+                        std::chrono::seconds second = {},
+                        std::chrono::milliseconds millisecond = {}) noexcept;
+
+    /* Returns time of day of dt truncated to milliseconds. */
+    template <typename Duration>
+    constexpr explicit TimeOfDay(const BasicDateTime<Duration>& dt) noexcept;
+
+    constexpr std::chrono::milliseconds since_midnight() const noexcept;
+
+    constexpr std::chrono::hours hour() const noexcept;
+
+    constexpr std::chrono::minutes minute() const noexcept;
+
+    constexpr std::chrono::seconds second() const noexcept;
+
+    constexpr std::chrono::milliseconds millisecond() const noexcept;
+
+private:
+    static constexpr std::int64_t millis_per_day{86'400'000};
+
+    std::uint32_t millis_;
+};
+
+constexpr bool operator==(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept;
+
+constexpr bool operator!=(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept;
+
+constexpr bool operator<(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept;
+
+constexpr bool operator>(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept;
+
+constexpr bool operator<=(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept;
+
+constexpr bool operator>=(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept;
+
+template <typename Rep, typename Period>
+constexpr TimeOfDay
+operator+(const TimeOfDay& time,
+          const std::chrono::duration<Rep, Period>& duration) noexcept;
+
+template <typename Rep, typename Period>
+constexpr TimeOfDay
+operator-(const TimeOfDay& time,
+          const std::chrono::duration<Rep, Period>& duration) noexcept;
+
+/* Returns time from rhs forward to lhs in [0, 24h), so 01:00 - 23:00 is 2h.
+ */
+constexpr std::chrono::milliseconds operator-(const TimeOfDay& lhs,
+                                              const TimeOfDay& rhs) noexcept;
+
+constexpr DateTime operator+(const Date& date, const TimeOfDay& time) noexcept;
+
+#if defined(__cpp_consteval)
+#define DW_CONSTEVAL consteval
+#else
+#define DW_CONSTEVAL constexpr
+#endif
+
+inline namespace literals {
+
+/* Returns Date parsed from "yyyy-MM-dd" string, i.e. "2019-05-10"_date.
+ *
+ * Literals are parsed at compile time and invalid literals fail to compile
+ * when compiler supports consteval. Otherwise, that is only guaranteed when
+ * result is used in constant expression, i.e. to initialize constexpr
+ * variable; std::invalid_argument is thrown for invalid literal at runtime.
+ */
+DW_CONSTEVAL Date operator""_date(const char* str, std::size_t len);
+
+/* Returns DateTime parsed from "yyyy-MM-ddThh:mm:ss" string with optional
+ * fraction of second up to nanoseconds and optional 'Z' suffix, i.e.
+ * "2019-05-10T10:00:00.250Z"_dt. Time is always treated as UTC.
+ *
+ * See "_date" literal for compile-time guarantees.
+ */
+DW_CONSTEVAL DateTime operator""_dt(const char* str, std::size_t len);
+
+} // namespace literals
+
+namespace utils {
+
+constexpr date::weekday convert(dw::Weekday weekday) noexcept;
+
+std::tm get_local_time();
+
+/* Convert std::tm to std::chrono::timepoint. */
+template <typename Clock, typename Duration>
+void fill_timepoint(const std::tm& t,
+                    std::chrono::time_point<Clock, Duration>& tp);
+
+constexpr Date from_ymd(const date::year_month_day& ymd) noexcept;
+
+constexpr date::year_month_day to_ymd(const Date& date) noexcept;
+
+/* Returns number of days since 1970-01-01. */
+constexpr long long serial_day(const Date& date) noexcept;
+
+/* Returns number of months since January of year 0. */
+constexpr long long month_index(const Date& date) noexcept;
+
+/* Returns number of set bits. */
+constexpr long long popcount(unsigned value) noexcept;
+
+/* Parses "yyyy-MM-dd" string. Throws std::invalid_argument if string doesn't
+ * represent valid date. */
+constexpr Date parse_iso_date(std::string_view str);
+
+/* Parses "yyyy-MM-ddThh:mm:ss[.f...][Z]" string. Throws std::invalid_argument
+ * if string doesn't represent valid date and time. */
+constexpr DateTime parse_iso_date_time(std::string_view str);
+
+} // namespace utils
+
+// Year implementation
+
+constexpr Year::Year(int year) noexcept
+    : year_{year}
+{
+}
+
+constexpr Year::operator int() const noexcept
+{
+    return static_cast<int>(year_);
+}
+
+constexpr bool operator==(const Year& lhs, const Year& rhs) noexcept
+{
+    return static_cast<int>(lhs) == static_cast<int>(rhs);
+}
+
+constexpr bool operator!=(const Year& lhs, const Year& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// Month implementation
+
+constexpr Month::Month(unsigned month) noexcept
+    : month_{static_cast<decltype(month_)>(month)}
+{
+}
+
+constexpr Month::operator unsigned() const noexcept
+{
+    return static_cast<unsigned>(month_);
+}
+
+constexpr bool operator==(const Month& lhs, const Month& rhs) noexcept
+{
+    return static_cast<unsigned>(lhs) == static_cast<unsigned>(rhs);
+}
+
+constexpr bool operator!=(const Month& lhs, const Month& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// Day implementation
+
+constexpr Day::Day(unsigned day) noexcept
+    : day_{static_cast<decltype(day_)>(day)}
+{
+}
+
+constexpr Day::operator unsigned() const noexcept
+{
+    return static_cast<unsigned>(day_);
+}
+
+constexpr bool operator==(const Day& lhs, const Day& rhs) noexcept
+{
+    return static_cast<unsigned>(lhs) == static_cast<unsigned>(rhs);
+}
+
+constexpr bool operator!=(const Day& lhs, const Day& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// Date implementation
+
+constexpr Date::Date(Year year, Month month, Day day) noexcept
+    : ymd_{date::year{static_cast<int>(year)},
+           date::month{static_cast<unsigned>(month)},
+           date::day{static_cast<unsigned>(day)}}
+{
+}
+
+constexpr Year Date::year() const noexcept
+{
+    return Year{static_cast<int>(ymd_.year())};
+}
+
+constexpr Month Date::month() const noexcept
+{
+    return Month{static_cast<unsigned>(ymd_.month())};
+}
+
+constexpr Day Date::day() const noexcept
+{
+    return Day{static_cast<unsigned>(ymd_.day())};
+}
+
+constexpr bool Date::valid() const noexcept { return ymd_.ok(); }
+
+constexpr Date::operator sys_days() const noexcept { return ymd_; }
+
+constexpr Date prev_weekday(const Date& date, Weekday target) noexcept
+{
+    const date::sys_days sd{utils::to_ymd(date)};
+    const date::weekday target_weekday{static_cast<unsigned>(target) + 1};
+    return Date{utils::from_ymd(
+        date::year_month_day{sd - (date::weekday{sd} - target_weekday)})};
+}
+
+constexpr Date prev_weekday_excluding_current(const Date& date,
+                                              Weekday target) noexcept
+{
+    return prev_weekday(date - Days{1}, target);
+}
+
+constexpr Date next_weekday(const Date& date, Weekday target) noexcept
+{
+    const date::sys_days sd{utils::to_ymd(date)};
+    const date::weekday target_weekday{static_cast<unsigned>(target) + 1};
+    return Date{utils::from_ymd(
+        date::year_month_day{sd + (target_weekday - date::weekday{sd})})};
+}
+
+constexpr Date next_weekday_excluding_current(const Date& date,
+                                              Weekday target) noexcept
+{
+    return next_weekday(date + Days{1}, target);
+}
+
+constexpr Date last_day_of_month(const Date& date) noexcept
+{
+    const auto ymd = utils::to_ymd(date);
+    return Date{utils::from_ymd(
+        date::year_month_day{ymd.year() / ymd.month() / date::last})};
+}
+
+inline constexpr Weekday weekday(const Date& date) noexcept
+{
+    return static_cast<Weekday>(
+        date::weekday(utils::to_ymd(date)).iso_encoding() - 1);
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE Date current_date() noexcept
+{
+    auto timepoint = std::chrono::system_clock::now();
+    date::year_month_day ymd{std::chrono::floor<date::days>(timepoint)};
+    return Date{Year{static_cast<int>(ymd.year())},
+                Month{static_cast<unsigned>(ymd.month())},
+                Day{static_cast<unsigned>(ymd.day())}};
+}
+
+DW_OUT_OF_LINE Date current_date_local() noexcept
+{
+    std::tm localTime = utils::get_local_time();
+    return Date{Year{localTime.tm_year + 1900},
+                Month{static_cast<unsigned>(localTime.tm_mon + 1)},
+                Day{static_cast<unsigned>(localTime.tm_mday)}};
+}
+
+#endif
+
+inline constexpr Date operator+(const Date& date, const Days& days) noexcept
+{
+    const auto s_days = date::sys_days{utils::to_ymd(date)} + days;
+    return Date{utils::from_ymd(s_days)};
+}
+
+inline constexpr Date operator-(const Date& date, const Days& days) noexcept
+{
+    return date + -days;
+}
+
+inline constexpr Date operator+(const Date& date, const Weeks& weeks) noexcept
+{
+    return date + Days{weeks.count() * 7};
+}
+
+inline constexpr Date operator-(const Date& date, const Weeks& weeks) noexcept
+{
+    return date - Days{weeks.count() * 7};
+}
+
+inline constexpr Date operator+(const Date& date, const Months& months) noexcept
+{
+    auto ymd = utils::to_ymd(date);
+    ymd += date::months{months.count()};
+    if (!ymd.ok()) {
+        DW_INSTRUMENT_CONSTEXPR_COUNT(MonthClamp);
+        ymd = ymd.year() / ymd.month() / date::last;
+    }
+    return Date{utils::from_ymd(ymd)};
+}
+
+inline constexpr Date operator-(const Date& date, const Months& months) noexcept
+{
+    return date + -months;
+}
+
+inline constexpr Date operator+(const Date& date, const Years& years) noexcept
+{
+    auto ymd = utils::to_ymd(date) + date::years{years.count()};
+    if (!ymd.ok()) {
+        DW_INSTRUMENT_CONSTEXPR_COUNT(YearClamp);
+        ymd = ymd.year() / ymd.month() / date::last;
+    }
+    return utils::from_ymd(ymd);
+}
+
+inline constexpr Date operator-(const Date& date, const Years& years) noexcept
+{
+    return date + -years;
+}
+
+inline constexpr Date normalize(const Date& date) noexcept
+{
+    DW_INSTRUMENT_CONSTEXPR_COUNT(Normalize);
+    auto ymd = utils::to_ymd(date);
+    ymd += date::months{0};
+    ymd = date::sys_days{ymd};
+    return utils::from_ymd(ymd);
+}
+
+inline constexpr bool operator==(const Date& lhs, const Date& rhs) noexcept
+{
+    return static_cast<int>(lhs.year()) == static_cast<int>(rhs.year()) &&
+           static_cast<unsigned>(lhs.month()) ==
+               static_cast<unsigned>(rhs.month()) &&
+           static_cast<unsigned>(lhs.day()) == static_cast<unsigned>(rhs.day());
+}
+
+constexpr bool operator!=(const Date& lhs, const Date& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+constexpr bool operator<=(const Date& lhs, const Date& rhs) noexcept
+{
+    return !(lhs > rhs);
+}
+
+constexpr bool operator<(const Date& lhs, const Date& rhs) noexcept
+{
+    return static_cast<int>(lhs.year()) < static_cast<int>(rhs.year())
+               ? true
+               : (static_cast<int>(lhs.year()) > static_cast<int>(rhs.year())
+                      ? false
+                      : (static_cast<unsigned>(lhs.month()) <
+                                 static_cast<unsigned>(rhs.month())
+                             ? true
+                             : (static_cast<unsigned>(lhs.month()) >
+                                        static_cast<unsigned>(rhs.month())
+                                    ? false
+                                    : (static_cast<unsigned>(lhs.day()) <
+                                       static_cast<unsigned>(rhs.day())))));
+}
+
+constexpr bool operator>=(const Date& lhs, const Date& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+constexpr bool operator>(const Date& lhs, const Date& rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+// BasicDateTime implementation
+
+template <typename Duration>
+template <typename Clock, typename TimePointDuration>
+inline constexpr BasicDateTime<Duration>::BasicDateTime(
+    const std::chrono::time_point<Clock, TimePointDuration>& timepoint) noexcept
+    : BasicDateTime{sys_days{std::chrono::floor<Days>(timepoint)
+                                 .time_since_epoch()},
+                    std::chrono::floor<Duration>(
+                        timepoint - std::chrono::floor<Days>(timepoint))}
+{
+}
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>::BasicDateTime(const Date& date) noexcept
+    : BasicDateTime{sys_days{date}, Duration::zero()}
+{
+}
+
+template <typename Duration>
+template <typename Rep, typename Period>
+inline constexpr BasicDateTime<Duration>::BasicDateTime(
+    const Date& date,
+    const std::chrono::duration<Rep, Period>& time_since_midnight) noexcept
+    : BasicDateTime{sys_days{date} +
+                        std::chrono::floor<Days>(time_since_midnight),
+                    std::chrono::floor<Duration>(
+                        time_since_midnight -
+                        std::chrono::floor<Days>(time_since_midnight))}
+{
+}
+
+template <typename Duration>
+template <typename OtherDuration>
+inline BasicDateTime<Duration>::BasicDateTime(
+    const BasicDateTime<OtherDuration>& other)
+    : BasicDateTime{other.day_point(),
+                    utils::checked_convert<Duration>(other.time())}
+{
+}
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>::BasicDateTime(sys_days day_point,
+                                                 Duration time) noexcept
+    : days_{std::chrono::duration_cast<decltype(days_)>(
+          day_point.time_since_epoch())}
+    , time_{static_cast<time_storage>(time.count())}
+{
+}
+
+template <typename Duration>
+constexpr date::year_month_day BasicDateTime<Duration>::ymd() const noexcept
+{
+    return date::year_month_day{day_point()};
+}
+
+template <typename Duration>
+constexpr Date BasicDateTime<Duration>::date() const noexcept
+{
+    return utils::from_ymd(ymd());
+}
+
+template <typename Duration>
+constexpr sys_days BasicDateTime<Duration>::day_point() const noexcept
+{
+    return sys_days{days_};
+}
+
+template <typename Duration>
+constexpr Year BasicDateTime<Duration>::year() const noexcept
+{
+    return Year{static_cast<int>(ymd().year())};
+}
+
+template <typename Duration>
+constexpr Month BasicDateTime<Duration>::month() const noexcept
+{
+    return Month{static_cast<unsigned>(ymd().month())};
+}
+
+template <typename Duration>
+constexpr Day BasicDateTime<Duration>::day() const noexcept
+{
+    return Day{static_cast<unsigned>(ymd().day())};
+}
+
+template <typename Duration>
+constexpr typename BasicDateTime<Duration>::precision
+BasicDateTime<Duration>::time() const noexcept
+{
+    return precision{static_cast<typename precision::rep>(time_)};
+}
+
+template <typename Duration>
+constexpr std::chrono::hours BasicDateTime<Duration>::hour() const noexcept
+{
+    return std::chrono::floor<std::chrono::hours>(time());
+}
+
+template <typename Duration>
+constexpr std::chrono::minutes BasicDateTime<Duration>::minute() const noexcept
+{
+    return std::chrono::floor<std::chrono::minutes>(time()) - hour();
+}
+
+template <typename Duration>
+constexpr std::chrono::seconds BasicDateTime<Duration>::second() const noexcept
+{
+    return std::chrono::floor<std::chrono::seconds>(time()) -
+           std::chrono::floor<std::chrono::minutes>(time());
+}
+
+template <typename Duration>
+constexpr Weekday BasicDateTime<Duration>::weekday() const noexcept
+{
+    return static_cast<Weekday>(
+        date::weekday{day_point()}.iso_encoding() - 1);
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE DateTime current_date_time() noexcept
+{
+    return DateTime{std::chrono::system_clock::now()};
+}
+
+DW_OUT_OF_LINE DateTime current_date_time_local() noexcept
+{
+    auto timepoint = std::chrono::system_clock::now();
+    std::tm localTime = utils::get_local_time();
+    utils::fill_timepoint(localTime, timepoint);
+    return DateTime{timepoint};
+}
+
+#endif
+
+template <typename ToDuration,
+          typename Clock,
+          typename Duration,
+          typename Precision>
+inline constexpr std::chrono::time_point<Clock, ToDuration>
+to_time_point(const BasicDateTime<Precision>& dt) noexcept
+{
+    using namespace std::chrono;
+    return time_point_cast<ToDuration>(dt.day_point()) +
+           std::chrono::floor<ToDuration>(dt.time());
+}
+
+template <typename Duration>
+inline constexpr bool operator==(const BasicDateTime<Duration>& lhs,
+                                 const BasicDateTime<Duration>& rhs) noexcept
+{
+    return lhs.day_point() == rhs.day_point() && lhs.time() == rhs.time();
+}
+
+template <typename Duration>
+inline constexpr bool operator!=(const BasicDateTime<Duration>& lhs,
+                                 const BasicDateTime<Duration>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template <typename Duration>
+inline constexpr bool operator<(const BasicDateTime<Duration>& lhs,
+                                const BasicDateTime<Duration>& rhs) noexcept
+{
+    if (lhs.day_point() == rhs.day_point())
+        return lhs.time() < rhs.time();
+    return lhs.day_point() < rhs.day_point();
+}
+
+template <typename Duration>
+inline constexpr bool operator>(const BasicDateTime<Duration>& lhs,
+                                const BasicDateTime<Duration>& rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+template <typename Duration>
+inline constexpr bool operator<=(const BasicDateTime<Duration>& lhs,
+                                 const BasicDateTime<Duration>& rhs) noexcept
+{
+    return !(lhs > rhs);
+}
+
+template <typename Duration>
+inline constexpr bool operator>=(const BasicDateTime<Duration>& lhs,
+                                 const BasicDateTime<Duration>& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+template <typename Duration, typename Rep, typename Period>
+inline constexpr BasicDateTime<Duration>
+operator+(const BasicDateTime<Duration>& dt,
+          const std::chrono::duration<Rep, Period>& duration) noexcept
+{
+    auto whole_days = std::chrono::floor<Days>(duration);
+    auto time_since_midnight = duration - whole_days + dt.time();
+    const auto overflow_day = std::chrono::floor<Days>(time_since_midnight);
+    time_since_midnight -= overflow_day;
+    whole_days += overflow_day;
+    const Date date{dt.date() + whole_days};
+    return BasicDateTime<Duration>(date, time_since_midnight);
+}
+
+template <typename Duration, typename Rep, typename Period>
+inline constexpr BasicDateTime<Duration>
+operator-(const BasicDateTime<Duration>& dt,
+          const std::chrono::duration<Rep, Period>& duration) noexcept
+{
+    return dt + -duration;
+}
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>
+operator+(const BasicDateTime<Duration>& dt, const Months& months) noexcept
+{
+    return BasicDateTime<Duration>{dt.date() + months, dt.time()};
+}
+
+template <typename Duration>
+constexpr BasicDateTime<Duration>
+operator-(const BasicDateTime<Duration>& dt, const Months& months) noexcept
+{
+    return dt + -months;
+}
+
+template <typename Duration>
+constexpr inline BasicDateTime<Duration>
+operator+(const BasicDateTime<Duration>& dt, const Years& years) noexcept
+{
+    return BasicDateTime<Duration>{dt.date() + years, dt.time()};
+}
+
+template <typename Duration>
+constexpr inline BasicDateTime<Duration>
+operator-(const BasicDateTime<Duration>& dt, const Years& years) noexcept
+{
+    return dt + -years;
+}
+
+// IsoDate implementation
+
+constexpr IsoDate::IsoDate() noexcept
+    : IsoDate{from_serial_day(0)}
+{
+}
+
+template <typename Clock, typename Duration>
+constexpr IsoDate::IsoDate(
+    const std::chrono::time_point<Clock, Duration>& time_point) noexcept
+    : IsoDate{from_serial_day(static_cast<long long>(
+          std::chrono::floor<Days>(time_point).time_since_epoch().count()))}
+{
+}
+
+template <typename Duration>
+constexpr IsoDate::IsoDate(const BasicDateTime<Duration>& dt) noexcept
+    : IsoDate{dt.date()}
+{
+}
+
+constexpr IsoDate::IsoDate(const Date& date) noexcept
+    : IsoDate{from_serial_day(utils::serial_day(date))}
+{
+}
+
+constexpr IsoDate::IsoDate(Year year,
+                           unsigned weeknum,
+                           Weekday weekday) noexcept
+    : packed_{static_cast<int>(year) * 512 + static_cast<int>(weeknum) * 8
+              + static_cast<int>(weekday) + 1}
+{
+}
+
+constexpr IsoDate::IsoDate(Packed, std::int32_t packed) noexcept
+    : packed_{packed}
+{
+}
+
+constexpr IsoDate IsoDate::from_serial_day(long long serial_day) noexcept
+{
+    // 1970-01-01 is Thursday, ISO weekday 4
+    const long long shifted = (serial_day + 3) % 7;
+    const long long weekday = (shifted < 0 ? shifted + 7 : shifted) + 1;
+    // Week belongs to the year of its Thursday
+    const long long thursday = serial_day - weekday + 4;
+    const int year = static_cast<int>(
+        date::year_month_day{date::sys_days{Days{thursday}}}.year());
+    const long long first_day = utils::serial_day(Date{Year{year}, Month{1},
+                                                       Day{1}});
+    const long long weeknum = (thursday - first_day) / 7 + 1;
+    return IsoDate{Packed{},
+                   static_cast<std::int32_t>(year * 512 + weeknum * 8
+                                             + weekday)};
+}
+
+constexpr IsoDate IsoDate::from_packed(std::int32_t packed) noexcept
+{
+    return IsoDate{Packed{}, packed};
+}
+
+constexpr unsigned IsoDate::weeknum() const noexcept
+{
+    return static_cast<unsigned>((packed_ >> 3) & 63);
+}
+
+constexpr Year IsoDate::year() const noexcept { return Year{packed_ >> 9}; }
+
+constexpr Weekday IsoDate::weekday() const noexcept
+{
+    return static_cast<Weekday>((packed_ & 7) - 1);
+}
+
+constexpr std::int32_t IsoDate::week_key() const noexcept
+{
+    return (packed_ >> 9) * 100 + ((packed_ >> 3) & 63);
+}
+
+constexpr Date IsoDate::date() const noexcept
+{
+    // January 4th is always in week 1
+    const Date fourth{year(), Month{1}, Day{4}};
+    const long long monday = utils::serial_day(
+        prev_weekday(fourth, Weekday::Monday));
+    const long long day = monday + (static_cast<long long>(weeknum()) - 1) * 7
+                          + static_cast<long long>(weekday());
+    return utils::from_ymd(date::year_month_day{date::sys_days{Days{day}}});
+}
+
+constexpr std::int32_t IsoDate::packed() const noexcept { return packed_; }
+
+inline constexpr bool operator==(const IsoDate& lhs,
+                                 const IsoDate& rhs) noexcept
+{
+    return lhs.packed() == rhs.packed();
+}
+
+inline constexpr bool operator!=(const IsoDate& lhs,
+                                 const IsoDate& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+inline constexpr bool operator<(const IsoDate& lhs,
+                                const IsoDate& rhs) noexcept
+{
+    return lhs.packed() < rhs.packed();
+}
+
+inline constexpr bool operator>(const IsoDate& lhs,
+                                const IsoDate& rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+inline constexpr bool operator<=(const IsoDate& lhs,
+                                 const IsoDate& rhs) noexcept
+{
+    return !(lhs > rhs);
+}
+
+inline constexpr bool operator>=(const IsoDate& lhs,
+                                 const IsoDate& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+namespace detail {
+
+/* Converts dates one by one, but reuses previous result when the next date
+ * falls later in the same ISO week, which is common for sorted input. */
+template <typename Store>
+void for_each_iso_date(span<const Date> dates, Store store)
+{
+    long long previous_day = 0;
+    IsoDate previous{};
+    for (std::size_t i = 0; i < dates.size(); ++i) {
+        const long long day = utils::serial_day(dates[i]);
+        const long long ahead = day - previous_day;
+        const long long left = 6 - static_cast<long long>(previous.weekday());
+        if (i != 0 && ahead >= 0 && ahead <= left) {
+            previous = IsoDate::from_packed(
+                previous.packed() + static_cast<std::int32_t>(ahead));
+        } else {
+            previous = IsoDate::from_serial_day(day);
+        }
+        previous_day = day;
+        store(i, previous);
+    }
+}
+
+} // namespace detail
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE void to_iso_week_keys(span<const Date> dates,
+                                     span<std::int32_t> keys)
+{
+    if (dates.size() != keys.size())
+        throw std::invalid_argument("dates and keys sizes differ");
+    detail::for_each_iso_date(
+        dates, [keys](std::size_t i, const IsoDate& iso_date) {
+            keys[i] = iso_date.week_key();
+        });
+}
+
+DW_OUT_OF_LINE void to_iso_dates(span<const Date> dates,
+                                 span<IsoDate> iso_dates)
+{
+    if (dates.size() != iso_dates.size())
+        throw std::invalid_argument("dates and iso_dates sizes differ");
+    detail::for_each_iso_date(
+        dates, [iso_dates](std::size_t i, const IsoDate& iso_date) {
+            iso_dates[i] = iso_date;
+        });
+}
+
+#endif
+
+// TimeOfDay implementation
+
+inline constexpr TimeOfDay::TimeOfDay() noexcept
+    : millis_{0}
+{
+}
+
+template <typename Rep, typename Period>
+inline constexpr TimeOfDay::TimeOfDay(
+    const std::chrono::duration<Rep, Period>& since_midnight) noexcept
+    : millis_{0}
+{
+    std::int64_t millis
+        = static_cast<std::int64_t>(
+              std::chrono::floor<std::chrono::milliseconds>(since_midnight)
+                  .count())
+          % millis_per_day;
+    if (millis < 0)
+        millis += millis_per_day;
+    millis_ = static_cast<std::uint32_t>(millis);
+}
+
+inline constexpr TimeOfDay::TimeOfDay(
+    std::chrono::hours hour,
+    std::chrono::minutes minute,
+    std::chrono::seconds second,
+    std::chrono::milliseconds millisecond) noexcept
+    : TimeOfDay{hour + minute + second + millisecond}
+{
+}
+
+template <typename Duration>
+inline constexpr TimeOfDay::TimeOfDay(
+    const BasicDateTime<Duration>& dt) noexcept
+    : TimeOfDay{dt.time()}
+{
+}
+
+inline constexpr std::chrono::milliseconds TimeOfDay::since_midnight() const
+    noexcept
+{
+    return std::chrono::milliseconds{millis_};
+}
+
+inline constexpr std::chrono::hours TimeOfDay::hour() const noexcept
+{
+    return std::chrono::hours{millis_ / 3'600'000};
+}
+
+inline constexpr std::chrono::minutes TimeOfDay::minute() const noexcept
+{
+    return std::chrono::minutes{millis_ / 60'000 % 60};
+}
+
+inline constexpr std::chrono::seconds TimeOfDay::second() const noexcept
+{
+    return std::chrono::seconds{millis_ / 1'000 % 60};
+}
+
+inline constexpr std::chrono::milliseconds TimeOfDay::millisecond() const
+    noexcept
+{
+    return std::chrono::milliseconds{millis_ % 1'000};
+}
+
+inline constexpr bool operator==(const TimeOfDay& lhs,
+                                 const TimeOfDay& rhs) noexcept
+{
+    return lhs.since_midnight() == rhs.since_midnight();
+}
+
+inline constexpr bool operator!=(const TimeOfDay& lhs,
+                                 const TimeOfDay& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+inline constexpr bool operator<(const TimeOfDay& lhs,
+                                const TimeOfDay& rhs) noexcept
+{
+    return lhs.since_midnight() < rhs.since_midnight();
+}
+
+inline constexpr bool operator>(const TimeOfDay& lhs,
+                                const TimeOfDay& rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+inline constexpr bool operator<=(const TimeOfDay& lhs,
+                                 const TimeOfDay& rhs) noexcept
+{
+    return !(lhs > rhs);
+}
+
+inline constexpr bool operator>=(const TimeOfDay& lhs,
+                                 const TimeOfDay& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+template <typename Rep, typename Period>
+inline constexpr TimeOfDay
+operator+(const TimeOfDay& time,
+          const std::chrono::duration<Rep, Period>& duration) noexcept
+{
+    // Whole days don't change time of day and are dropped before adding,
+    // so that large durations don't overflow
+    const auto millis
+        = std::chrono::floor<std::chrono::milliseconds>(duration).count()
+          % 86'400'000;
+    return TimeOfDay{time.since_midnight()
+                     + std::chrono::milliseconds{millis}};
+}
+
+template <typename Rep, typename Period>
+inline constexpr TimeOfDay
+operator-(const TimeOfDay& time,
+          const std::chrono::duration<Rep, Period>& duration) noexcept
+{
+    return time + -duration;
+}
+
+inline constexpr std::chrono::milliseconds
+operator-(const TimeOfDay& lhs, const TimeOfDay& rhs) noexcept
+{
+    return TimeOfDay{lhs.since_midnight() - rhs.since_midnight()}
+        .since_midnight();
+}
+
+inline constexpr DateTime operator+(const Date& date,
+                                    const TimeOfDay& time) noexcept
+{
+    return DateTime{date, time.since_midnight()};
+}
+
+// Literals implementation
+
+inline namespace literals {
+
+DW_CONSTEVAL Date operator""_date(const char* str, std::size_t len)
+{
+    return utils::parse_iso_date(std::string_view{str, len});
+}
+
+DW_CONSTEVAL DateTime operator""_dt(const char* str, std::size_t len)
+{
+    return utils::parse_iso_date_time(std::string_view{str, len});
+}
+
+} // namespace literals
+
+#undef DW_CONSTEVAL
+
+namespace utils {
+
+inline constexpr date::weekday convert(dw::Weekday weekday) noexcept
+{
+    return date::weekday{static_cast<unsigned>(weekday) + 1};
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE std::tm get_local_time() {
+    DW_INSTRUMENT_SCOPE(LocalTime);
+    auto timepoint = std::chrono::system_clock::now();
+    std::time_t t = std::chrono::system_clock::to_time_t(timepoint);
+#ifdef _MSC_VER
+    std::tm localTime;
+    localtime_s(&localTime, &t);
+#else
+    std::tm localTime = *std::localtime(&t);
+#endif
+    return localTime;
+}
+
+#endif
+
+/* Convert std::tm to std::chrono::timepoint. */
+template <typename Clock, typename Duration>
+inline void fill_timepoint(const std::tm& t,
+                           std::chrono::time_point<Clock, Duration>& tp)
+{
+    using namespace std::chrono;
+    using namespace date;
+    int y = t.tm_year + 1900;
+    auto ymd = date::year(y) / (t.tm_mon + 1) / t.tm_mday;
+    if (!ymd.ok())
+        throw std::runtime_error("Invalid date");
+    tp = sys_days(ymd) + hours(t.tm_hour) + minutes(t.tm_min) +
+         seconds(t.tm_sec);
+}
+
+constexpr Date from_ymd(const date::year_month_day& ymd) noexcept
+{
+    return Date{Year{static_cast<int>(ymd.year())},
+                Month{static_cast<unsigned>(ymd.month())},
+                Day{static_cast<unsigned>(ymd.day())}};
+}
+
+constexpr date::year_month_day to_ymd(const Date& date) noexcept
+{
+    return date::year_month_day{
+        date::year{static_cast<int>(date.year())},
+        date::month{static_cast<unsigned>(date.month())},
+        date::day{static_cast<unsigned>(date.day())}};
+}
+
+inline constexpr long long serial_day(const Date& date) noexcept
+{
+    return static_cast<long long>(sys_days{date}.time_since_epoch().count());
+}
+
+inline constexpr long long popcount(unsigned value) noexcept
+{
+    long long count = 0;
+    for (; value != 0; value &= value - 1)
+        ++count;
+    return count;
+}
+
+inline constexpr long long month_index(const Date& date) noexcept
+{
+    return static_cast<long long>(static_cast<int>(date.year())) * 12
+           + static_cast<long long>(static_cast<unsigned>(date.month())) - 1;
+}
+
+constexpr unsigned
+parse_digits(std::string_view str, std::size_t pos, std::size_t count)
+{
+    if (pos + count > str.size())
+        throw std::invalid_argument("unexpected end of date string");
+    unsigned value{0};
+    for (std::size_t i = pos; i < pos + count; ++i) {
+        if (str[i] < '0' || str[i] > '9')
+            throw std::invalid_argument("digit expected in date string");
+        value = value * 10 + static_cast<unsigned>(str[i] - '0');
+    }
+    return value;
+}
+
+constexpr void expect_char(std::string_view str, std::size_t pos, char ch)
+{
+    if (pos >= str.size() || str[pos] != ch)
+        throw std::invalid_argument("unexpected character in date string");
+}
+
+inline constexpr Date parse_iso_date(std::string_view str)
+{
+    if (str.size() != 10)
+        throw std::invalid_argument("date string must be yyyy-MM-dd");
+    expect_char(str, 4, '-');
+    expect_char(str, 7, '-');
+    const Date date{Year{static_cast<int>(parse_digits(str, 0, 4))},
+                    Month{parse_digits(str, 5, 2)},
+                    Day{parse_digits(str, 8, 2)}};
+    if (!date.valid())
+        throw std::invalid_argument("invalid date");
+    return date;
+}
+
+inline constexpr DateTime parse_iso_date_time(std::string_view str)
+{
+    using namespace std::chrono;
+    if (str.size() < 19)
+        throw std::invalid_argument("date time string is too short");
+    const Date date{parse_iso_date(str.substr(0, 10))};
+    expect_char(str, 10, 'T');
+    expect_char(str, 13, ':');
+    expect_char(str, 16, ':');
+    const unsigned h = parse_digits(str, 11, 2);
+    const unsigned m = parse_digits(str, 14, 2);
+    const unsigned s = parse_digits(str, 17, 2);
+    if (h > 23 || m > 59 || s > 59)
+        throw std::invalid_argument("invalid time of day");
+    std::size_t pos{19};
+    nanoseconds fraction{0};
+    if (pos < str.size() && str[pos] == '.') {
+        ++pos;
+        const std::size_t first{pos};
+        long long ns{0};
+        while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+            if (pos - first == 9)
+                throw std::invalid_argument("fraction is too precise");
+            ns = ns * 10 + (str[pos] - '0');
+            ++pos;
+        }
+        if (pos == first)
+            throw std::invalid_argument("digit expected in fraction");
+        for (std::size_t digits = pos - first; digits < 9; ++digits)
+            ns *= 10;
+        fraction = nanoseconds{ns};
+    }
+    if (pos < str.size() && str[pos] == 'Z')
+        ++pos;
+    if (pos != str.size())
+        throw std::invalid_argument("unexpected trailing characters");
+    return DateTime{date,
+                    hours{static_cast<int>(h)} + minutes{static_cast<int>(m)}
+                        + seconds{static_cast<int>(s)}
+                        + floor<DateTime::precision>(fraction)};
+}
+
+template <class Duration, class Rep, class Period>
+inline Duration checked_convert(std::chrono::duration<Rep, Period> d)
+{
+    using namespace std::chrono;
+    using S = duration<double, typename Duration::period>;
+    constexpr S m = Duration::min();
+    constexpr S M = Duration::max();
+    S s = d;
+    if (s < m || s > M)
+        throw std::overflow_error("checked_convert");
+    return duration_cast<Duration>(s);
+}
+
+} // namespace utils
+
+} // namespace dw
+
+namespace std {
+
+template <> struct hash<dw::IsoDate> {
+    std::size_t operator()(const dw::IsoDate& iso_date) const noexcept
+    {
+        return std::hash<std::int32_t>{}(iso_date.packed());
+    }
+};
+
+} // namespace std
+
+#endif /* end of include guard: CORE_H_R7QK2M4D */
@@ -0,0 +1,375 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef CSV_H_N2TG7RXB
+#define CSV_H_N2TG7RXB
+
+#include "format.h"
+#include "parallel.h"
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dw {
+
+namespace utils {
+
+/* Describes how Range is written to and read from CSV row. */
+template <typename Range> struct CsvTraits;
+
+template <> struct CsvTraits<DateRange> {
+    static constexpr FormatKind kind{FormatKind::Date};
+    static constexpr std::string_view format{"yyyy-MM-dd"};
+
+    static constexpr DateRange parse(std::string_view start,
+                                     std::string_view finish);
+};
+
+template <> struct CsvTraits<DateTimeRange> {
+    static constexpr FormatKind kind{FormatKind::DateAndTime};
+    static constexpr std::string_view format{"yyyy-MM-ddThh:mm:ss.zzzzzzzzz"};
+
+    static constexpr DateTimeRange parse(std::string_view start,
+                                         std::string_view finish);
+};
+
+} // namespace utils
+
+/* Row that failed to parse. Lines are numbered from 1. */
+struct CsvError {
+    std::size_t line;
+    std::string message;
+};
+
+template <typename Range> struct CsvReadResult {
+    std::vector<Range> rows;
+    std::vector<CsvError> errors;
+};
+
+/* Writes ranges as "start<delimiter>finish" CSV rows.
+ *
+ * Rows are formatted with a CompiledFormat directly into a chunk buffer,
+ * which is written to the stream when full, on flush() and on destruction.
+ * Formats other than the default one produce rows that read_csv() doesn't
+ * understand.
+ */
+template <typename Range> class CsvWriter {
+public:
+    explicit CsvWriter(
+        std::ostream& os,
+        std::string_view format = utils::CsvTraits<Range>::format,
+        char delimiter = ',',
+        std::size_t chunk_size = 64 * 1024);
+
+    CsvWriter(const CsvWriter&) = delete;
+
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    ~CsvWriter();
+
+    void write(const Range& range);
+
+    void write(span<const Range> ranges);
+
+    /* Writes buffered rows to the stream. */
+    void flush();
+
+private:
+    std::ostream& os_;
+    CompiledFormat format_;
+    char delimiter_;
+    std::size_t row_size_;
+    std::vector<char> buffer_;
+    std::size_t size_{0};
+};
+
+using DateRangeCsvWriter = CsvWriter<DateRange>;
+
+using DateTimeRangeCsvWriter = CsvWriter<DateTimeRange>;
+
+/* Parses CSV rows written by CsvWriter with the default format. Dates are
+ * "yyyy-MM-dd" and date times are "yyyy-MM-ddThh:mm:ss[.f...][Z]".
+ *
+ * Input is typically a memory mapped file; rows are parsed in place without
+ * copying. Empty lines are skipped and "\r\n" line ends are accepted. Rows
+ * that fail to parse are reported in errors and don't stop parsing.
+ *
+ * Input is split into chunks at line boundaries which are parsed on
+ * concurrency threads; concurrency of 0 means
+ * std::thread::hardware_concurrency(). Small inputs are parsed on the
+ * calling thread. Rows keep input order.
+ */
+template <typename Range>
+CsvReadResult<Range> read_csv(std::string_view input,
+                              char delimiter = ',',
+                              unsigned concurrency = 0);
+
+/* Incremental parser for input that arrives in chunks. A row may span
+ * chunks; only its incomplete tail is copied until the next chunk arrives.
+ */
+template <typename Range> class CsvReader {
+public:
+    explicit CsvReader(char delimiter = ',');
+
+    /* Parses complete rows of chunk into result. */
+    void feed(std::string_view chunk, CsvReadResult<Range>& result);
+
+    /* Parses the last row when input doesn't end with a line break. */
+    void finish(CsvReadResult<Range>& result);
+
+private:
+    char delimiter_;
+    std::size_t lines_{0};
+    std::string tail_;
+};
+
+namespace utils {
+
+/* Parses complete and incomplete lines of input into result, numbering them
+ * from first_line + 1. Returns number of lines. */
+template <typename Range>
+std::size_t parse_csv_lines(std::string_view input,
+                            char delimiter,
+                            std::size_t first_line,
+                            CsvReadResult<Range>& result);
+
+} // namespace utils
+
+// CsvTraits implementation
+
+namespace utils {
+
+constexpr DateRange CsvTraits<DateRange>::parse(std::string_view start,
+                                                std::string_view finish)
+{
+    return DateRange{parse_iso_date(start), parse_iso_date(finish)};
+}
+
+constexpr DateTimeRange
+CsvTraits<DateTimeRange>::parse(std::string_view start,
+                                std::string_view finish)
+{
+    return DateTimeRange{parse_iso_date_time(start),
+                         parse_iso_date_time(finish)};
+}
+
+} // namespace utils
+
+// CsvWriter implementation
+
+template <typename Range>
+CsvWriter<Range>::CsvWriter(std::ostream& os,
+                            std::string_view format,
+                            char delimiter,
+                            std::size_t chunk_size)
+    : os_{os}
+    , format_{format, utils::CsvTraits<Range>::kind}
+    , delimiter_{delimiter}
+    , row_size_{format_.max_size() * 2 + 2}
+    , buffer_(std::max(chunk_size, row_size_))
+{
+}
+
+template <typename Range> CsvWriter<Range>::~CsvWriter()
+{
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+template <typename Range> void CsvWriter<Range>::write(const Range& range)
+{
+    if (buffer_.size() - size_ < row_size_)
+        flush();
+    char* const first = buffer_.data() + size_;
+    char* out = format_.format_to(first, range.start());
+    *out++ = delimiter_;
+    out = format_.format_to(out, range.finish());
+    *out++ = '\n';
+    size_ += static_cast<std::size_t>(out - first);
+}
+
+template <typename Range>
+void CsvWriter<Range>::write(span<const Range> ranges)
+{
+    for (const auto& range : ranges)
+        write(range);
+}
+
+template <typename Range> void CsvWriter<Range>::flush()
+{
+    if (size_ == 0)
+        return;
+    os_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+    size_ = 0;
+}
+
+// CSV reading implementation
+
+template <typename Range>
+CsvReadResult<Range>
+read_csv(std::string_view input, char delimiter, unsigned concurrency)
+{
+    constexpr std::size_t min_chunk_size{64 * 1024};
+    const std::size_t chunks = std::max<std::size_t>(
+        1,
+        std::min<std::size_t>(
+            concurrency == 0
+                ? std::max(1u, std::thread::hardware_concurrency())
+                : concurrency,
+            input.size() / min_chunk_size));
+    CsvReadResult<Range> result;
+    if (chunks == 1) {
+        utils::parse_csv_lines(input, delimiter, 0, result);
+        return result;
+    }
+
+    // Chunk boundaries are moved past the next line break
+    std::vector<std::size_t> bounds{0};
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+        const std::size_t line_end = input.find(
+            '\n', std::max(bounds.back(), input.size() * chunk / chunks));
+        if (line_end == std::string_view::npos)
+            break;
+        bounds.push_back(line_end + 1);
+    }
+    bounds.push_back(input.size());
+
+    const std::size_t parts = bounds.size() - 1;
+    std::vector<CsvReadResult<Range>> locals(parts);
+    std::vector<std::size_t> lines(parts);
+    // One part per chunk, every part is already a line-aligned slice
+    utils::for_each_chunk(
+        parts,
+        static_cast<unsigned>(parts),
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t part = first; part < last; ++part)
+                lines[part] = utils::parse_csv_lines(
+                    input.substr(bounds[part],
+                                 bounds[part + 1] - bounds[part]),
+                    delimiter,
+                    0,
+                    locals[part]);
+        },
+        1);
+
+    std::size_t rows{0};
+    for (const auto& local : locals)
+        rows += local.rows.size();
+    result.rows.reserve(rows);
+    std::size_t first_line{0};
+    for (std::size_t part = 0; part < parts; ++part) {
+        result.rows.insert(result.rows.end(),
+                           locals[part].rows.cbegin(),
+                           locals[part].rows.cend());
+        for (auto& error : locals[part].errors) {
+            error.line += first_line;
+            result.errors.push_back(std::move(error));
+        }
+        first_line += lines[part];
+    }
+    return result;
+}
+
+template <typename Range>
+CsvReader<Range>::CsvReader(char delimiter)
+    : delimiter_{delimiter}
+{
+}
+
+template <typename Range>
+void CsvReader<Range>::feed(std::string_view chunk,
+                            CsvReadResult<Range>& result)
+{
+    const std::size_t last_break = chunk.rfind('\n');
+    if (last_break == std::string_view::npos) {
+        tail_ += chunk;
+        return;
+    }
+    std::string_view complete{chunk.substr(0, last_break + 1)};
+    if (!tail_.empty()) {
+        // Row that spans chunks is completed by the first line of this one
+        const std::size_t first_break = complete.find('\n');
+        tail_ += complete.substr(0, first_break + 1);
+        lines_ += utils::parse_csv_lines<Range>(
+            tail_, delimiter_, lines_, result);
+        complete.remove_prefix(first_break + 1);
+    }
+    lines_ += utils::parse_csv_lines<Range>(
+        complete, delimiter_, lines_, result);
+    tail_.assign(chunk.substr(last_break + 1));
+}
+
+template <typename Range>
+void CsvReader<Range>::finish(CsvReadResult<Range>& result)
+{
+    lines_ += utils::parse_csv_lines<Range>(tail_, delimiter_, lines_, result);
+    tail_.clear();
+}
+
+namespace utils {
+
+template <typename Range>
+std::size_t parse_csv_lines(std::string_view input,
+                            char delimiter,
+                            std::size_t first_line,
+                            CsvReadResult<Range>& result)
+{
+    std::size_t line{first_line};
+    while (!input.empty()) {
+        ++line;
+        const std::size_t line_end = input.find('\n');
+        std::string_view row{input.substr(0, line_end)};
+        input.remove_prefix(line_end == std::string_view::npos
+                                ? input.size()
+                                : line_end + 1);
+        if (!row.empty() && row.back() == '\r')
+            row.remove_suffix(1);
+        if (row.empty())
+            continue;
+        const std::size_t split = row.find(delimiter);
+        if (split == std::string_view::npos) {
+            result.errors.push_back(CsvError{line, "delimiter expected"});
+            continue;
+        }
+        try {
+            result.rows.push_back(CsvTraits<Range>::parse(
+                row.substr(0, split), row.substr(split + 1)));
+        } catch (const std::invalid_argument& e) {
+            result.errors.push_back(CsvError{line, e.what()});
+        }
+    }
+    return line - first_line;
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: CSV_H_N2TG7RXB */
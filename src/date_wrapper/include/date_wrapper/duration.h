@@ -0,0 +1,491 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef DURATION_H_T9CM4HQS
+#define DURATION_H_T9CM4HQS
+
+#include "format.h"
+#include "range.h"
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dw {
+
+/* Duration format compiled into a sequence of fields and literal text.
+ *
+ * These expressions may be used:
+ *
+ * d	the days without leading zeroes
+ * dd	the days with at least two digits
+ * h hh	the hours without / with a leading zero
+ * m mm	the minutes without / with a leading zero
+ * s ss	the seconds without / with a leading zero
+ * z zzz zzzzzz zzzzzzzzz	the fraction of second, see
+ * to_string(const DateTime& ...)
+ *
+ * The largest unit in the format holds the rest of the duration, so
+ * "h:mm:ss" formats 26 hours as "26:00:00", while "d'd' hh:mm:ss" formats it
+ * as "1d 02:00:00". Negative durations are written with leading '-'.
+ * Quoting rules are the same as for to_string(const DateTime& ...).
+ *
+ * Durations are converted to nanoseconds and must fit into them.
+ */
+class DurationFormat {
+public:
+    explicit DurationFormat(std::string_view format);
+
+    /* Returns upper bound of formatted value size. */
+    std::size_t max_size() const noexcept;
+
+    /* Writes formatted value to the buffer that must hold at least
+     * max_size() chars and returns pointer past the last written char. */
+    template <typename Rep, typename Period>
+    char* format_to(char* out,
+                    std::chrono::duration<Rep, Period> duration) const
+        noexcept;
+
+    char* format_to(char* out, const DateTimeRange& range) const noexcept;
+
+    template <typename Rep, typename Period>
+    std::string format(std::chrono::duration<Rep, Period> duration) const;
+
+    std::string format(const DateTimeRange& range) const;
+
+private:
+    struct Token {
+        utils::FormatField field;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    std::vector<Token> tokens_;
+    std::string literals_;
+    std::size_t max_size_{1};
+    // Rank of the largest unit, see utils::elapsed_rank()
+    unsigned top_rank_{0};
+
+    char* write(char* out, std::chrono::nanoseconds duration) const noexcept;
+};
+
+/* Upper bound of write_humanized() output size. */
+constexpr std::size_t humanized_max_size{40};
+
+/* Upper bound of write_iso_duration() output size. */
+constexpr std::size_t iso_duration_max_size{32};
+
+/* Writes duration as up to max_units consecutive units starting from the
+ * largest non-zero one, skipping zero units, i.e. "2d 3h", "1h 5m" or
+ * "250ms". Units are d, h, m, s, ms, us and ns. Zero duration is "0s".
+ * Buffer must hold at least humanized_max_size chars. */
+template <typename Rep, typename Period>
+char* write_humanized(char* out,
+                      std::chrono::duration<Rep, Period> duration,
+                      unsigned max_units = 2) noexcept;
+
+/* Writes ISO 8601 duration with days and time, i.e. "P2DT3H14M7S" or
+ * "PT0.25S". Negative durations are written with leading '-'.
+ * Buffer must hold at least iso_duration_max_size chars. */
+template <typename Rep, typename Period>
+char* write_iso_duration(char* out,
+                         std::chrono::duration<Rep, Period> duration) noexcept;
+
+/* Parses ISO 8601 duration "[-]PnW" or "[-]P[nD][T[nH][nM][n[.f]S]]".
+ * Fraction of second is allowed with up to nine digits.
+ * Throws std::invalid_argument if string isn't such duration, including
+ * durations with years and months as they have no fixed length, and
+ * std::overflow_error if duration doesn't fit into nanoseconds. */
+constexpr std::chrono::nanoseconds parse_iso_duration(std::string_view str);
+
+namespace utils {
+
+char* write_humanized(char* out,
+                      std::chrono::nanoseconds duration,
+                      unsigned max_units) noexcept;
+
+char* write_iso_duration(char* out,
+                         std::chrono::nanoseconds duration) noexcept;
+
+/* Returns 4 for days, 3 for hours, 2 for minutes, 1 for seconds and 0 for
+ * other fields. */
+constexpr unsigned elapsed_rank(FormatField field) noexcept;
+
+/* Returns magnitude of duration in nanoseconds. */
+constexpr unsigned long long
+magnitude(std::chrono::nanoseconds duration) noexcept;
+
+} // namespace utils
+
+// DurationFormat implementation
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE DurationFormat::DurationFormat(std::string_view format)
+{
+    using utils::FormatField;
+    while (!format.empty()) {
+        const auto token
+            = utils::next_format_token(format, FormatKind::Elapsed);
+        if (token.field != FormatField::Literal) {
+            tokens_.push_back(Token{token.field, 0, 0});
+            top_rank_ = std::max(top_rank_, utils::elapsed_rank(token.field));
+            continue;
+        }
+        if (token.text.empty())
+            continue;
+        if (!tokens_.empty() && tokens_.back().field == FormatField::Literal)
+            tokens_.back().length
+                += static_cast<std::uint32_t>(token.text.size());
+        else
+            tokens_.push_back(
+                Token{FormatField::Literal,
+                      static_cast<std::uint32_t>(literals_.size()),
+                      static_cast<std::uint32_t>(token.text.size())});
+        literals_ += token.text;
+        max_size_ += token.text.size();
+    }
+    // Largest unit isn't bounded by the next one
+    for (const auto& token : tokens_) {
+        const unsigned rank = utils::elapsed_rank(token.field);
+        max_size_ += rank != 0 && rank == top_rank_
+                         ? 20
+                         : utils::max_field_size(token.field);
+    }
+}
+
+DW_OUT_OF_LINE std::size_t DurationFormat::max_size() const noexcept
+{
+    return max_size_;
+}
+
+#endif
+
+template <typename Rep, typename Period>
+char* DurationFormat::format_to(
+    char* out, std::chrono::duration<Rep, Period> duration) const noexcept
+{
+    using std::chrono::nanoseconds;
+    return write(out, std::chrono::duration_cast<nanoseconds>(duration));
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE char* DurationFormat::format_to(char* out,
+                                               const DateTimeRange& range) const
+    noexcept
+{
+    return write(out, range.duration<std::chrono::nanoseconds>());
+}
+
+#endif
+
+template <typename Rep, typename Period>
+std::string
+DurationFormat::format(std::chrono::duration<Rep, Period> duration) const
+{
+    std::string result(max_size_, '\0');
+    result.resize(static_cast<std::size_t>(
+        format_to(result.data(), duration) - result.data()));
+    return result;
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE std::string
+DurationFormat::format(const DateTimeRange& range) const
+{
+    std::string result(max_size_, '\0');
+    result.resize(static_cast<std::size_t>(format_to(result.data(), range)
+                                           - result.data()));
+    return result;
+}
+
+DW_OUT_OF_LINE char* DurationFormat::write(char* out,
+                                           std::chrono::nanoseconds duration)
+    const noexcept
+{
+    constexpr unsigned long long units[] = {
+        1'000'000'000ULL, 60'000'000'000ULL, 3'600'000'000'000ULL,
+        86'400'000'000'000ULL};
+    unsigned long long rest = utils::magnitude(duration);
+    if (rest != 0 && duration.count() < 0)
+        *out++ = '-';
+    unsigned long long values[4] = {0, 0, 0, 0};
+    for (unsigned rank = top_rank_; rank > 0; --rank) {
+        values[rank - 1] = rest / units[rank - 1];
+        rest %= units[rank - 1];
+    }
+    const utils::FormatValues format_values{
+        0,
+        0,
+        static_cast<unsigned>(values[3]),
+        static_cast<long long>(values[2]),
+        static_cast<long long>(values[1]),
+        static_cast<long long>(values[0]),
+        static_cast<long long>(rest % units[0])};
+    for (const auto& token : tokens_) {
+        if (token.field == utils::FormatField::Literal)
+            out = std::copy_n(
+                literals_.data() + token.offset, token.length, out);
+        else
+            out = utils::write_field(out, token.field, format_values, false);
+    }
+    return out;
+}
+
+#endif
+
+// Duration writers implementation
+
+template <typename Rep, typename Period>
+char* write_humanized(char* out,
+                      std::chrono::duration<Rep, Period> duration,
+                      unsigned max_units) noexcept
+{
+    return utils::write_humanized(
+        out,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration),
+        max_units);
+}
+
+template <typename Rep, typename Period>
+char* write_iso_duration(char* out,
+                         std::chrono::duration<Rep, Period> duration) noexcept
+{
+    return utils::write_iso_duration(
+        out, std::chrono::duration_cast<std::chrono::nanoseconds>(duration));
+}
+
+constexpr std::chrono::nanoseconds parse_iso_duration(std::string_view str)
+{
+    struct Unit {
+        char designator;
+        bool time;
+        long long nanos;
+    };
+    constexpr Unit units[] = {{'W', false, 604'800'000'000'000LL},
+                              {'D', false, 86'400'000'000'000LL},
+                              {'H', true, 3'600'000'000'000LL},
+                              {'M', true, 60'000'000'000LL},
+                              {'S', true, 1'000'000'000LL}};
+    constexpr long long max{std::numeric_limits<long long>::max()};
+
+    std::size_t pos{0};
+    const bool negative{!str.empty() && str[0] == '-'};
+    if (!str.empty() && (str[0] == '-' || str[0] == '+'))
+        ++pos;
+    if (pos >= str.size() || str[pos] != 'P')
+        throw std::invalid_argument("duration string must start with P");
+    ++pos;
+    long long total{0};
+    std::size_t next_unit{0};
+    bool time{false};
+    bool any{false};
+    bool any_time{false};
+    while (pos < str.size()) {
+        if (str[pos] == 'T') {
+            if (time)
+                throw std::invalid_argument("repeated T in duration string");
+            time = true;
+            ++pos;
+            continue;
+        }
+        const std::size_t first{pos};
+        long long value{0};
+        while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+            if (value > (max - (str[pos] - '0')) / 10)
+                throw std::overflow_error("duration is out of range");
+            value = value * 10 + (str[pos] - '0');
+            ++pos;
+        }
+        if (pos == first)
+            throw std::invalid_argument("digit expected in duration string");
+        long long fraction{0};
+        bool has_fraction{false};
+        if (pos < str.size() && (str[pos] == '.' || str[pos] == ',')) {
+            has_fraction = true;
+            const std::size_t fraction_first{++pos};
+            while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+                if (pos - fraction_first == 9)
+                    throw std::invalid_argument("fraction is too precise");
+                fraction = fraction * 10 + (str[pos] - '0');
+                ++pos;
+            }
+            if (pos == fraction_first)
+                throw std::invalid_argument("digit expected in fraction");
+            for (std::size_t digits = pos - fraction_first; digits < 9;
+                 ++digits)
+                fraction *= 10;
+        }
+        if (pos == str.size())
+            throw std::invalid_argument("designator expected");
+        const char designator{str[pos++]};
+        if (!time && (designator == 'Y' || designator == 'M'))
+            throw std::invalid_argument(
+                "years and months have no fixed duration");
+        std::size_t unit{next_unit};
+        while (unit < std::size(units)
+               && (units[unit].designator != designator
+                   || units[unit].time != time))
+            ++unit;
+        if (unit == std::size(units))
+            throw std::invalid_argument(
+                "unexpected designator in duration string");
+        if (has_fraction && designator != 'S')
+            throw std::invalid_argument("only seconds may have fraction");
+        if (value > (max - total - fraction) / units[unit].nanos)
+            throw std::overflow_error("duration is out of range");
+        total += value * units[unit].nanos + fraction;
+        next_unit = unit + 1;
+        any = true;
+        any_time = any_time || time;
+    }
+    if (!any || (time && !any_time))
+        throw std::invalid_argument("duration string has no components");
+    return std::chrono::nanoseconds{negative ? -total : total};
+}
+
+namespace utils {
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE char* write_humanized(char* out,
+                                     std::chrono::nanoseconds duration,
+                                     unsigned max_units) noexcept
+{
+    struct Unit {
+        std::string_view suffix;
+        unsigned long long nanos;
+    };
+    constexpr Unit units[] = {{"d", 86'400'000'000'000ULL},
+                              {"h", 3'600'000'000'000ULL},
+                              {"m", 60'000'000'000ULL},
+                              {"s", 1'000'000'000ULL},
+                              {"ms", 1'000'000ULL},
+                              {"us", 1'000ULL},
+                              {"ns", 1ULL}};
+    unsigned long long rest = magnitude(duration);
+    if (rest == 0)
+        return write_text(out, "0s");
+    if (duration.count() < 0)
+        *out++ = '-';
+    unsigned left{std::max(max_units, 1u)};
+    bool started{false};
+    for (const auto& unit : units) {
+        const unsigned long long value = rest / unit.nanos;
+        rest %= unit.nanos;
+        if (value != 0) {
+            if (started)
+                *out++ = ' ';
+            out = write_padded(out, static_cast<long long>(value), 1);
+            out = write_text(out, unit.suffix);
+            started = true;
+        }
+        if (started && --left == 0)
+            break;
+    }
+    return out;
+}
+
+DW_OUT_OF_LINE char* write_iso_duration(char* out,
+                                        std::chrono::nanoseconds duration)
+    noexcept
+{
+    unsigned long long rest = magnitude(duration);
+    if (rest != 0 && duration.count() < 0)
+        *out++ = '-';
+    *out++ = 'P';
+    const unsigned long long days = rest / 86'400'000'000'000ULL;
+    rest %= 86'400'000'000'000ULL;
+    if (days != 0) {
+        out = write_padded(out, static_cast<long long>(days), 1);
+        *out++ = 'D';
+    }
+    if (rest == 0 && days != 0)
+        return out;
+    *out++ = 'T';
+    const unsigned long long hours = rest / 3'600'000'000'000ULL;
+    rest %= 3'600'000'000'000ULL;
+    const unsigned long long minutes = rest / 60'000'000'000ULL;
+    rest %= 60'000'000'000ULL;
+    const unsigned long long seconds = rest / 1'000'000'000ULL;
+    unsigned long long nanos = rest % 1'000'000'000ULL;
+    if (hours != 0) {
+        out = write_padded(out, static_cast<long long>(hours), 1);
+        *out++ = 'H';
+    }
+    if (minutes != 0) {
+        out = write_padded(out, static_cast<long long>(minutes), 1);
+        *out++ = 'M';
+    }
+    if (seconds != 0 || nanos != 0 || (hours == 0 && minutes == 0)) {
+        out = write_padded(out, static_cast<long long>(seconds), 1);
+        if (nanos != 0) {
+            std::size_t width{9};
+            for (; nanos % 10 == 0; nanos /= 10)
+                --width;
+            *out++ = '.';
+            out = write_padded(out, static_cast<long long>(nanos), width);
+        }
+        *out++ = 'S';
+    }
+    return out;
+}
+
+#endif
+
+constexpr unsigned elapsed_rank(FormatField field) noexcept
+{
+    switch (field) {
+    case FormatField::Day:
+    case FormatField::Day2:
+        return 4;
+    case FormatField::Hour:
+    case FormatField::Hour2:
+        return 3;
+    case FormatField::Minute:
+    case FormatField::Minute2:
+        return 2;
+    case FormatField::Second:
+    case FormatField::Second2:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+constexpr unsigned long long
+magnitude(std::chrono::nanoseconds duration) noexcept
+{
+    const auto count = duration.count();
+    return count < 0 ? 0ULL - static_cast<unsigned long long>(count)
+                     : static_cast<unsigned long long>(count);
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: DURATION_H_T9CM4HQS */
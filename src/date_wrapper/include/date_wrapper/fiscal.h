@@ -0,0 +1,379 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef FISCAL_H_W9CK3FZR
+#define FISCAL_H_W9CK3FZR
+
+#include "core.h"
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace dw {
+
+/* Position of a date in a fiscal calendar. All fields are 1-based: quarter
+ * is in [1, 4], period in [1, 12] and week in [1, 53]. */
+struct FiscalPeriod {
+    Year year{0};
+    unsigned quarter{0};
+    unsigned period{0};
+    unsigned week{0};
+};
+
+constexpr bool operator==(const FiscalPeriod& lhs, const FiscalPeriod& rhs);
+
+constexpr bool operator!=(const FiscalPeriod& lhs, const FiscalPeriod& rhs);
+
+/* Fiscal calendar of twelve periods per year, grouped into four quarters of
+ * three periods each, over a fixed span of fiscal years.
+ *
+ * Boundaries are computed once when the calendar is built. Every day of the
+ * covered span is stored in a table with its packed FiscalPeriod, so lookup
+ * is a subtraction and an array access, and start dates of all periods are
+ * stored in order, so the DateRange of any year, quarter or period is read
+ * from two adjacent entries. Weeks are counted from the first day of the
+ * fiscal year. All returned ranges are inclusive.
+ *
+ * Calendars are usually built with make_monthly_calendar or
+ * make_retail_calendar. A fiscal year is named after the calendar year in
+ * which it ends.
+ */
+class FiscalCalendar {
+public:
+    /* period_starts holds start dates of all periods of consecutive fiscal
+     * years, followed by the day after the last period, that is
+     * 12 * years + 1 dates. first_year is the name of the first fiscal year.
+     * Throws std::invalid_argument if the size is wrong, the dates are not
+     * strictly increasing or a fiscal year is longer than 53 weeks. */
+    FiscalCalendar(Year first_year, span<const Date> period_starts);
+
+    Year first_year() const noexcept;
+
+    Year last_year() const noexcept;
+
+    /* Returns range of days covered by all fiscal years of the calendar. */
+    DateRange range() const noexcept;
+
+    /* Throws std::out_of_range if the date is outside of range(). */
+    FiscalPeriod lookup(const Date& date) const;
+
+    /* Stores lookup(dates[i]) into periods[i].
+     * Throws std::invalid_argument if sizes differ and std::out_of_range if a
+     * date is outside of range(). */
+    void lookup(span<const Date> dates, span<FiscalPeriod> periods) const;
+
+    /* Range functions throw std::out_of_range if fiscal year is not covered
+     * by the calendar or quarter, period or week is not in the year. */
+    DateRange year_range(Year fiscal_year) const;
+
+    DateRange quarter_range(Year fiscal_year, unsigned quarter) const;
+
+    DateRange period_range(Year fiscal_year, unsigned period) const;
+
+    /* Last week of a year of whole months may be shorter than 7 days. */
+    DateRange week_range(Year fiscal_year, unsigned week) const;
+
+private:
+    static constexpr std::size_t periods_per_year{12};
+    static constexpr long long max_year_days{371};
+
+    int first_year_;
+    long long first_day_;
+    // Serial days of period starts and of the day after the last period
+    std::vector<long long> period_starts_;
+    // year offset << 16 | period << 8 | week for every covered day
+    std::vector<std::uint32_t> days_;
+
+    std::size_t year_offset(Year fiscal_year) const;
+
+    DateRange days_range(long long first, long long next) const noexcept;
+
+    FiscalPeriod unpack(std::uint32_t entry) const noexcept;
+};
+
+/* Number of weeks in each period of a quarter of a 52/53-week calendar. */
+enum class RetailPattern { P445, P454, P544 };
+
+/* Rule that picks the last day of a 52/53-week fiscal year. */
+enum class YearEnd {
+    // Last given weekday of the end month
+    LastWeekday,
+    // Given weekday nearest to the last day of the end month
+    NearestWeekday
+};
+
+/* Builds calendar whose periods are calendar months and fiscal years start on
+ * the first day of start_month. Fiscal year Y ends with the month before
+ * start_month of calendar year Y, or with December of Y if start_month is
+ * January.
+ * Throws std::invalid_argument if last < first. */
+FiscalCalendar make_monthly_calendar(Month start_month, Year first, Year last);
+
+/* Builds 52/53-week calendar. Fiscal year Y ends on the end_weekday picked by
+ * rule from end_month of calendar year Y and starts on the day after the end
+ * of year Y - 1. Periods of each quarter have 4 or 5 weeks as given by
+ * pattern, and the 53rd week of a long year is added to the last period.
+ * Throws std::invalid_argument if last < first. */
+FiscalCalendar make_retail_calendar(RetailPattern pattern,
+                                    Month end_month,
+                                    Weekday end_weekday,
+                                    YearEnd rule,
+                                    Year first,
+                                    Year last);
+
+// FiscalPeriod implementation
+
+inline constexpr bool operator==(const FiscalPeriod& lhs,
+                                 const FiscalPeriod& rhs)
+{
+    return lhs.year == rhs.year && lhs.quarter == rhs.quarter
+           && lhs.period == rhs.period && lhs.week == rhs.week;
+}
+
+inline constexpr bool operator!=(const FiscalPeriod& lhs,
+                                 const FiscalPeriod& rhs)
+{
+    return !(lhs == rhs);
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+// FiscalCalendar implementation
+
+DW_OUT_OF_LINE FiscalCalendar::FiscalCalendar(Year first_year,
+                                              span<const Date> period_starts)
+    : first_year_{static_cast<int>(first_year)}
+    , first_day_{0}
+{
+    if (period_starts.size() < periods_per_year + 1
+        || (period_starts.size() - 1) % periods_per_year != 0)
+        throw std::invalid_argument(
+            "FiscalCalendar needs 12 period starts per year and an end");
+    const std::size_t years = (period_starts.size() - 1) / periods_per_year;
+    if (years > 0xffff)
+        throw std::invalid_argument("FiscalCalendar covers too many years");
+
+    period_starts_.reserve(period_starts.size());
+    for (const Date& date : period_starts) {
+        const long long day = utils::serial_day(date);
+        if (!period_starts_.empty() && day <= period_starts_.back())
+            throw std::invalid_argument(
+                "FiscalCalendar period starts are not increasing");
+        period_starts_.push_back(day);
+    }
+    first_day_ = period_starts_.front();
+
+    days_.reserve(
+        static_cast<std::size_t>(period_starts_.back() - first_day_));
+    for (std::size_t year = 0; year < years; ++year) {
+        const std::size_t base = year * periods_per_year;
+        const long long year_start = period_starts_[base];
+        if (period_starts_[base + periods_per_year] - year_start
+            > max_year_days)
+            throw std::invalid_argument(
+                "FiscalCalendar year is longer than 53 weeks");
+        for (std::size_t period = 0; period < periods_per_year; ++period) {
+            for (long long day = period_starts_[base + period];
+                 day < period_starts_[base + period + 1];
+                 ++day) {
+                const auto week
+                    = static_cast<std::uint32_t>((day - year_start) / 7 + 1);
+                days_.push_back(static_cast<std::uint32_t>(year) << 16
+                                | static_cast<std::uint32_t>(period + 1) << 8
+                                | week);
+            }
+        }
+    }
+}
+
+DW_OUT_OF_LINE Year FiscalCalendar::first_year() const noexcept
+{
+    return Year{first_year_};
+}
+
+DW_OUT_OF_LINE Year FiscalCalendar::last_year() const noexcept
+{
+    return Year{first_year_
+                + static_cast<int>(period_starts_.size() / periods_per_year)
+                - 1};
+}
+
+DW_OUT_OF_LINE DateRange FiscalCalendar::range() const noexcept
+{
+    return days_range(period_starts_.front(), period_starts_.back());
+}
+
+DW_OUT_OF_LINE FiscalPeriod FiscalCalendar::lookup(const Date& date) const
+{
+    const long long offset = utils::serial_day(date) - first_day_;
+    if (offset < 0 || offset >= static_cast<long long>(days_.size()))
+        throw std::out_of_range("date is outside of FiscalCalendar");
+    return unpack(days_[static_cast<std::size_t>(offset)]);
+}
+
+DW_OUT_OF_LINE void FiscalCalendar::lookup(span<const Date> dates,
+                                           span<FiscalPeriod> periods) const
+{
+    if (dates.size() != periods.size())
+        throw std::invalid_argument("dates and periods sizes differ");
+    const auto size = static_cast<long long>(days_.size());
+    for (std::size_t i = 0; i < dates.size(); ++i) {
+        const long long offset = utils::serial_day(dates[i]) - first_day_;
+        if (offset < 0 || offset >= size)
+            throw std::out_of_range("date is outside of FiscalCalendar");
+        periods[i] = unpack(days_[static_cast<std::size_t>(offset)]);
+    }
+}
+
+DW_OUT_OF_LINE DateRange FiscalCalendar::year_range(Year fiscal_year) const
+{
+    const std::size_t base = year_offset(fiscal_year) * periods_per_year;
+    return days_range(period_starts_[base],
+                      period_starts_[base + periods_per_year]);
+}
+
+DW_OUT_OF_LINE DateRange FiscalCalendar::quarter_range(Year fiscal_year,
+                                                       unsigned quarter) const
+{
+    if (quarter < 1 || quarter > 4)
+        throw std::out_of_range("fiscal quarter is not in [1, 4]");
+    const std::size_t base = year_offset(fiscal_year) * periods_per_year
+                             + (quarter - 1) * 3;
+    return days_range(period_starts_[base], period_starts_[base + 3]);
+}
+
+DW_OUT_OF_LINE DateRange FiscalCalendar::period_range(Year fiscal_year,
+                                                      unsigned period) const
+{
+    if (period < 1 || period > periods_per_year)
+        throw std::out_of_range("fiscal period is not in [1, 12]");
+    const std::size_t base
+        = year_offset(fiscal_year) * periods_per_year + period - 1;
+    return days_range(period_starts_[base], period_starts_[base + 1]);
+}
+
+DW_OUT_OF_LINE DateRange FiscalCalendar::week_range(Year fiscal_year,
+                                                    unsigned week) const
+{
+    const std::size_t base = year_offset(fiscal_year) * periods_per_year;
+    const long long year_start = period_starts_[base];
+    const long long year_next = period_starts_[base + periods_per_year];
+    const long long first = year_start + 7 * static_cast<long long>(week) - 7;
+    if (week < 1 || first >= year_next)
+        throw std::out_of_range("fiscal week is not in the year");
+    return days_range(first, std::min(first + 7, year_next));
+}
+
+DW_OUT_OF_LINE std::size_t FiscalCalendar::year_offset(Year fiscal_year) const
+{
+    const int offset = static_cast<int>(fiscal_year) - first_year_;
+    if (offset < 0 || offset > static_cast<int>(last_year()) - first_year_)
+        throw std::out_of_range("fiscal year is outside of FiscalCalendar");
+    return static_cast<std::size_t>(offset);
+}
+
+DW_OUT_OF_LINE DateRange FiscalCalendar::days_range(long long first,
+                                                    long long next) const
+    noexcept
+{
+    const Date start{Date{Year{1970}, Month{1}, Day{1}} + Days{first}};
+    return DateRange{start, start + Days{next - first - 1}};
+}
+
+DW_OUT_OF_LINE FiscalPeriod FiscalCalendar::unpack(std::uint32_t entry) const
+    noexcept
+{
+    const unsigned period = entry >> 8 & 0xff;
+    return FiscalPeriod{Year{first_year_ + static_cast<int>(entry >> 16)},
+                        (period - 1) / 3 + 1,
+                        period,
+                        entry & 0xff};
+}
+
+// Calendar factories implementation
+
+DW_OUT_OF_LINE FiscalCalendar make_monthly_calendar(Month start_month,
+                                                    Year first,
+                                                    Year last)
+{
+    if (static_cast<int>(last) < static_cast<int>(first))
+        throw std::invalid_argument("last fiscal year is before first");
+    const int shift = static_cast<unsigned>(start_month) == 1 ? 0 : 1;
+    const Date start{
+        Year{static_cast<int>(first) - shift}, start_month, Day{1}};
+    const auto periods = static_cast<std::size_t>(
+        static_cast<int>(last) - static_cast<int>(first) + 1) * 12;
+    std::vector<Date> starts;
+    starts.reserve(periods + 1);
+    for (std::size_t i = 0; i <= periods; ++i)
+        starts.push_back(start + Months{static_cast<long long>(i)});
+    return FiscalCalendar{first, starts};
+}
+
+DW_OUT_OF_LINE FiscalCalendar make_retail_calendar(RetailPattern pattern,
+                                                   Month end_month,
+                                                   Weekday end_weekday,
+                                                   YearEnd rule,
+                                                   Year first,
+                                                   Year last)
+{
+    if (static_cast<int>(last) < static_cast<int>(first))
+        throw std::invalid_argument("last fiscal year is before first");
+    const auto year_end = [&](int year) {
+        const Date month_end{
+            last_day_of_month(Date{Year{year}, end_month, Day{1}})};
+        return rule == YearEnd::LastWeekday
+                   ? prev_weekday(month_end, end_weekday)
+                   : prev_weekday(month_end + Days{3}, end_weekday);
+    };
+    long long weeks[3]{4, 4, 5};
+    if (pattern == RetailPattern::P454)
+        weeks[1] = 5, weeks[2] = 4;
+    else if (pattern == RetailPattern::P544)
+        weeks[0] = 5, weeks[2] = 4;
+
+    std::vector<Date> starts;
+    starts.reserve(static_cast<std::size_t>(static_cast<int>(last)
+                                            - static_cast<int>(first) + 1)
+                       * 12
+                   + 1);
+    Date start{year_end(static_cast<int>(first) - 1) + Days{1}};
+    for (int year = static_cast<int>(first); year <= static_cast<int>(last);
+         ++year) {
+        for (std::size_t period = 0; period < 12; ++period) {
+            starts.push_back(start);
+            start = start + Weeks{weeks[period % 3]};
+        }
+        // 53-week year: the extra week goes to the last period
+        start = year_end(year) + Days{1};
+    }
+    starts.push_back(start);
+    return FiscalCalendar{first, starts};
+}
+
+#endif
+
+} // namespace dw
+
+#endif /* end of include guard: FISCAL_H_W9CK3FZR */
@@ -0,0 +1,799 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef FORMAT_H_B6LP9Z2C
+#define FORMAT_H_B6LP9Z2C
+
+#include "core.h"
+#include "range.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dw {
+
+/* Return string representation of Date.
+ * The format parameter determines the format of the result string.
+ *
+ * These expressions may be used for the date:
+ *
+ * d	the day as number without a leading zero (1 to 31)
+ * dd	the day as number with a leading zero (01 to 31)
+ * M	the month as number without a leading zero (1-12)
+ * MM	the month as number with a leading zero (01-12)
+ * yy	the year as two digit number (00-99)
+ * yyyy	the year as four digit number
+ *
+ * All other input characters will be ignored.
+ * Any sequence of characters that are enclosed in single quotes will be
+ * treated as text and not be used as an expression.
+ */
+std::string to_string(const Date& date, std::string_view format);
+
+/* Return string representation of DateTime.
+ * The format parameter determines the format of the result string.
+ *
+ * These expressions may be used for the date:
+ *
+ * d	the day as number without a leading zero (1 to 31)
+ * dd	the day as number with a leading zero (01 to 31)
+ * M	the month as number without a leading zero (1-12)
+ * MM	the month as number with a leading zero (01-12)
+ * yy	the year as two digit number (00-99)
+ * yyyy	the year as four digit number
+ *
+ * These expressions may be used for the time:
+ *
+ * h	the hour without a leading zero (0 to 23 or 1 to 12 if AM/PM
+ * display)
+ * hh	the hour with a leading zero (00 to 23 or 01 to 12 if AM/PM
+ * display)
+ * m	the minute without a leading zero (0 to 59)
+ * mm	the minute with a leading zero (00 to 59)
+ * s	the second without a leading zero (0 to 59)
+ * ss	the second with a leading zero (00 to 59)
+ * z	the milliseconds without leading zeroes (0 to 999)
+ * zzz	the milliseconds with leading zeroes (000 to 999)
+ * zzzzzz	the microseconds with leading zeroes (000000 to 999999)
+ * zzzzzzzzz	the nanoseconds with leading zeroes (000000000 to 999999999)
+ * AP	use AM/PM display, AP will be replaced by either "AM" or "PM"
+ * ap	use am/pm display, ap will be replaced by either "am" or "pm"
+ *
+ * All other input characters will be ignored.
+ * Any sequence of characters that are enclosed in single quotes will be
+ * treated as text and not be used as an expression.
+ */
+template <typename Duration>
+std::string to_string(const BasicDateTime<Duration>& dt,
+                      std::string_view format);
+
+/* Return string representation of TimeOfDay. Time expressions of
+ * to_string(const DateTime& ...) may be used, date expressions are treated
+ * as text.
+ */
+std::string to_string(const TimeOfDay& time, std::string_view format);
+
+std::string to_string(const DateRange& ds,
+                      std::string_view format,
+                      std::string sep = " - ");
+
+/* Return string representation of DateTimeRange. The result is determined
+ * by format string that is applied both to start and finish DateTime
+ * objects, separated by sep string.
+ * See also documentation for to_string(const DateTime& ...) for format
+ * specification.
+ */
+std::string to_string(const DateTimeRange& date_time_range,
+                      std::string_view format,
+                      std::string sep = " - ");
+
+/* Expressions understood by a format. Time formats understand only time
+ * expressions. Elapsed formats understand day and time expressions that
+ * format durations, see DurationFormat. */
+enum class FormatKind { Date, DateAndTime, Time, Elapsed };
+
+namespace utils {
+
+enum class FormatField : std::uint8_t {
+    Literal,
+    Year4,
+    Year2,
+    Month2,
+    Month,
+    Day2,
+    Day,
+    Hour2,
+    Hour,
+    Minute2,
+    Minute,
+    Second2,
+    Second,
+    Millis,
+    Millis3,
+    Micros6,
+    Nanos9,
+    AmPmUpper,
+    AmPmLower
+};
+
+/* Single expression or literal text of a format string. Literal text is a
+ * view into the format string. */
+struct FormatToken {
+    FormatField field;
+    std::string_view text;
+};
+
+/* Date and time fields consumed by formatting. */
+struct FormatValues {
+    int year;
+    unsigned month;
+    unsigned day;
+    long long hour;
+    long long minute;
+    long long second;
+    long long nanos;
+};
+
+} // namespace utils
+
+/* Format string compiled into a sequence of fields and literal text.
+ *
+ * Compiling a format once and reusing it avoids parsing the format string
+ * for every formatted value. Formats of FormatKind::Date understand only
+ * date expressions, see to_string(const Date& ...), formats of
+ * FormatKind::DateAndTime understand both date and time expressions, see
+ * to_string(const DateTime& ...).
+ */
+class CompiledFormat {
+public:
+    explicit CompiledFormat(std::string_view format,
+                            FormatKind kind = FormatKind::DateAndTime);
+
+    /* Returns upper bound of formatted value size. */
+    std::size_t max_size() const noexcept;
+
+    /* Writes formatted value to the buffer that must hold at least
+     * max_size() chars and returns pointer past the last written char. */
+    char* format_to(char* out, const Date& date) const noexcept;
+
+    template <typename Duration>
+    char* format_to(char* out, const BasicDateTime<Duration>& dt) const
+        noexcept;
+
+    std::string format(const Date& date) const;
+
+    template <typename Duration>
+    std::string format(const BasicDateTime<Duration>& dt) const;
+
+    char* format_to(char* out, const TimeOfDay& time) const noexcept;
+
+    std::string format(const TimeOfDay& time) const;
+
+    /* Parses time of day written with this format. Two-letter expressions
+     * take exactly two digits, one-letter ones one or two, z takes one to
+     * three digits and the longer fractions exactly their width. AM/PM
+     * markers are matched ignoring case.
+     * Throws std::invalid_argument if str doesn't match the format, the time
+     * is out of range or the format has date expressions. */
+    TimeOfDay parse_time_of_day(std::string_view str) const;
+
+private:
+    struct Token {
+        utils::FormatField field;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    std::vector<Token> tokens_;
+    std::string literals_;
+    std::size_t max_size_{0};
+    bool twelve_hour_{false};
+
+    char* write(char* out, const utils::FormatValues& values) const noexcept;
+};
+
+namespace utils {
+
+bool startsWith(std::string_view str, std::string_view prefix);
+
+bool startsWith(std::string_view str, char ch);
+
+template <typename Duration>
+std::string formatDateTime(const BasicDateTime<Duration>& dt,
+                           std::string_view format);
+
+char* write_padded(char* out, long long value, std::size_t width) noexcept;
+
+/* Removes next expression or literal text from the format and returns it. */
+constexpr FormatToken next_format_token(std::string_view& format,
+                                        FormatKind kind) noexcept;
+
+/* Returns upper bound of size of formatted expression. */
+constexpr std::size_t max_field_size(FormatField field) noexcept;
+
+constexpr FormatValues format_values(const Date& date) noexcept;
+
+constexpr FormatValues format_values(const TimeOfDay& time) noexcept;
+
+template <typename Duration>
+constexpr FormatValues
+format_values(const BasicDateTime<Duration>& dt) noexcept;
+
+/* Writes formatted expression that is not a literal. */
+char* write_field(char* out,
+                  FormatField field,
+                  const FormatValues& values,
+                  bool twelve_hour) noexcept;
+
+/* Writes Date in dd.MM.yyyy form used by stream insertion. Buffer must hold
+ * at least 19 chars. */
+char* write_date(char* out, const Date& date) noexcept;
+
+/* Writes DateTime in dd.MM.yyyy hh:mm:ss form used by stream insertion.
+ * Buffer must hold at least 28 chars. */
+template <typename Duration>
+char* write_date_time(char* out, const BasicDateTime<Duration>& dt) noexcept;
+
+char* write_text(char* out, std::string_view text) noexcept;
+
+} // namespace utils
+
+// Date implementation
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE std::string to_string(const Date& date, std::string_view format)
+{
+    DW_INSTRUMENT_SCOPE(ToStringDate);
+    return CompiledFormat{format, FormatKind::Date}.format(date);
+}
+
+#endif
+
+// BasicDateTime implementation
+
+template <typename Duration>
+inline std::string to_string(const BasicDateTime<Duration>& dt,
+                             std::string_view format)
+{
+    DW_INSTRUMENT_SCOPE(ToStringDateTime);
+    return utils::formatDateTime(dt, format);
+}
+
+// TimeOfDay implementation
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE std::string to_string(const TimeOfDay& time,
+                                     std::string_view format)
+{
+    return CompiledFormat{format, FormatKind::Time}.format(time);
+}
+
+#endif
+
+// DateRange implementation
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE std::string
+to_string(const DateRange& ds, std::string_view format, std::string sep)
+{
+    DW_INSTRUMENT_SCOPE(ToStringDateRange);
+    const CompiledFormat compiled{format, FormatKind::Date};
+    std::string result{compiled.format(ds.start())};
+    result += sep;
+    result += compiled.format(ds.finish());
+    return result;
+}
+
+#endif
+
+// DateTimeRange implementation
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE std::string to_string(const DateTimeRange& date_time_range,
+                                     std::string_view format,
+                                     std::string sep)
+{
+    DW_INSTRUMENT_SCOPE(ToStringDateTimeRange);
+    const CompiledFormat compiled{format};
+    std::string result{compiled.format(date_time_range.start())};
+    result += sep;
+    result += compiled.format(date_time_range.finish());
+    return result;
+}
+
+#endif
+
+// CompiledFormat implementation
+
+template <typename Duration>
+inline char* CompiledFormat::format_to(char* out,
+                                       const BasicDateTime<Duration>& dt) const
+    noexcept
+{
+    return write(out, utils::format_values(dt));
+}
+
+template <typename Duration>
+inline std::string
+CompiledFormat::format(const BasicDateTime<Duration>& dt) const
+{
+    std::string result(max_size_, '\0');
+    result.resize(static_cast<std::size_t>(format_to(result.data(), dt)
+                                           - result.data()));
+    return result;
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE CompiledFormat::CompiledFormat(std::string_view format,
+                                              FormatKind kind)
+{
+    using utils::FormatField;
+    while (!format.empty()) {
+        const auto token = utils::next_format_token(format, kind);
+        if (token.field != FormatField::Literal) {
+            tokens_.push_back(Token{token.field, 0, 0});
+            max_size_ += utils::max_field_size(token.field);
+            twelve_hour_ = twelve_hour_ || token.field == FormatField::AmPmUpper
+                           || token.field == FormatField::AmPmLower;
+            continue;
+        }
+        if (token.text.empty())
+            continue;
+        if (!tokens_.empty() && tokens_.back().field == FormatField::Literal)
+            tokens_.back().length
+                += static_cast<std::uint32_t>(token.text.size());
+        else
+            tokens_.push_back(
+                Token{FormatField::Literal,
+                      static_cast<std::uint32_t>(literals_.size()),
+                      static_cast<std::uint32_t>(token.text.size())});
+        literals_ += token.text;
+        max_size_ += token.text.size();
+    }
+}
+
+DW_OUT_OF_LINE std::size_t CompiledFormat::max_size() const noexcept
+{
+    return max_size_;
+}
+
+DW_OUT_OF_LINE char* CompiledFormat::format_to(char* out,
+                                               const Date& date) const
+    noexcept
+{
+    return write(out, utils::format_values(date));
+}
+
+DW_OUT_OF_LINE std::string CompiledFormat::format(const Date& date) const
+{
+    std::string result(max_size_, '\0');
+    result.resize(static_cast<std::size_t>(format_to(result.data(), date)
+                                           - result.data()));
+    return result;
+}
+
+DW_OUT_OF_LINE char* CompiledFormat::format_to(char* out,
+                                               const TimeOfDay& time) const
+    noexcept
+{
+    return write(out, utils::format_values(time));
+}
+
+DW_OUT_OF_LINE std::string CompiledFormat::format(const TimeOfDay& time) const
+{
+    std::string result(max_size_, '\0');
+    result.resize(static_cast<std::size_t>(format_to(result.data(), time)
+                                           - result.data()));
+    return result;
+}
+
+DW_OUT_OF_LINE TimeOfDay
+CompiledFormat::parse_time_of_day(std::string_view str) const
+{
+    using utils::FormatField;
+    const auto fail = [] {
+        throw std::invalid_argument("string doesn't match time format");
+    };
+    // Reads between min_digits and max_digits digits
+    const auto digits = [&](std::size_t min_digits, std::size_t max_digits) {
+        long long value = 0;
+        std::size_t count = 0;
+        while (count < max_digits && count < str.size() && str[count] >= '0'
+               && str[count] <= '9')
+            value = value * 10 + (str[count++] - '0');
+        if (count < min_digits)
+            fail();
+        str.remove_prefix(count);
+        return value;
+    };
+    long long hour = 0;
+    long long minute = 0;
+    long long second = 0;
+    long long millis = 0;
+    int am_pm = -1;
+    for (const auto& token : tokens_) {
+        switch (token.field) {
+        case FormatField::Literal: {
+            const std::string_view text{literals_.data() + token.offset,
+                                        token.length};
+            if (!utils::startsWith(str, text))
+                fail();
+            str.remove_prefix(text.size());
+            break;
+        }
+        case FormatField::Hour2:
+            hour = digits(2, 2);
+            break;
+        case FormatField::Hour:
+            hour = digits(1, 2);
+            break;
+        case FormatField::Minute2:
+            minute = digits(2, 2);
+            break;
+        case FormatField::Minute:
+            minute = digits(1, 2);
+            break;
+        case FormatField::Second2:
+            second = digits(2, 2);
+            break;
+        case FormatField::Second:
+            second = digits(1, 2);
+            break;
+        case FormatField::Millis:
+            millis = digits(1, 3);
+            break;
+        case FormatField::Millis3:
+            millis = digits(3, 3);
+            break;
+        case FormatField::Micros6:
+            millis = digits(6, 6) / 1'000;
+            break;
+        case FormatField::Nanos9:
+            millis = digits(9, 9) / 1'000'000;
+            break;
+        case FormatField::AmPmUpper:
+        case FormatField::AmPmLower:
+            if (str.size() < 2 || (str[1] != 'M' && str[1] != 'm'))
+                fail();
+            if (str[0] == 'A' || str[0] == 'a')
+                am_pm = 0;
+            else if (str[0] == 'P' || str[0] == 'p')
+                am_pm = 1;
+            else
+                fail();
+            str.remove_prefix(2);
+            break;
+        default:
+            throw std::invalid_argument("time format has date expressions");
+        }
+    }
+    if (!str.empty() || minute > 59 || second > 59)
+        fail();
+    if (am_pm >= 0) {
+        if (hour < 1 || hour > 12)
+            fail();
+        hour = hour % 12 + 12 * am_pm;
+    } else if (hour > 23) {
+        fail();
+    }
+    return TimeOfDay{std::chrono::hours{hour},
+                     std::chrono::minutes{minute},
+                     std::chrono::seconds{second},
+                     std::chrono::milliseconds{millis}};
+}
+
+DW_OUT_OF_LINE char*
+CompiledFormat::write(char* out, const utils::FormatValues& values) const
+    noexcept
+{
+    for (const auto& token : tokens_) {
+        if (token.field == utils::FormatField::Literal)
+            out = std::copy_n(
+                literals_.data() + token.offset, token.length, out);
+        else
+            out = utils::write_field(out, token.field, values, twelve_hour_);
+    }
+    return out;
+}
+
+#endif
+
+namespace utils {
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE bool startsWith(std::string_view str, std::string_view prefix)
+{
+    if (prefix.size() > str.size())
+        return false;
+    return std::equal(prefix.cbegin(), prefix.cend(), str.cbegin());
+}
+
+DW_OUT_OF_LINE bool startsWith(std::string_view str, char ch)
+{
+    return !str.empty() && str[0] == ch;
+}
+
+#endif
+
+template <typename Duration>
+inline std::string formatDateTime(const BasicDateTime<Duration>& dt,
+                                  std::string_view format)
+{
+    return CompiledFormat{format}.format(dt);
+}
+
+template <typename Duration>
+inline char* write_date_time(char* out,
+                             const BasicDateTime<Duration>& dt) noexcept
+{
+    out = write_date(out, dt.date());
+    *out++ = ' ';
+    out = write_padded(out, static_cast<long long>(dt.hour().count()), 2);
+    *out++ = ':';
+    out = write_padded(out, static_cast<long long>(dt.minute().count()), 2);
+    *out++ = ':';
+    return write_padded(out, static_cast<long long>(dt.second().count()), 2);
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+/* Writes value padded with zeroes to at least width chars. */
+DW_OUT_OF_LINE char*
+write_padded(char* out, long long value, std::size_t width) noexcept
+{
+    char digits[20];
+    std::size_t count{0};
+    const bool negative{value < 0};
+    auto magnitude = negative ? 0ULL - static_cast<unsigned long long>(value)
+                              : static_cast<unsigned long long>(value);
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    const std::size_t size{count + (negative ? 1 : 0)};
+    for (std::size_t i = size; i < width; ++i)
+        *out++ = '0';
+    if (negative)
+        *out++ = '-';
+    while (count != 0)
+        *out++ = digits[--count];
+    return out;
+}
+
+#endif
+
+inline constexpr FormatToken next_format_token(std::string_view& format,
+                                               FormatKind kind) noexcept
+{
+    struct Expression {
+        std::string_view pattern;
+        FormatField field;
+        bool time;
+        bool elapsed;
+    };
+    // Longer expressions must precede their prefixes
+    constexpr Expression expressions[] = {
+        {"yyyy", FormatField::Year4, false, false},
+        {"yy", FormatField::Year2, false, false},
+        {"MM", FormatField::Month2, false, false},
+        {"M", FormatField::Month, false, false},
+        {"dd", FormatField::Day2, false, true},
+        {"d", FormatField::Day, false, true},
+        {"hh", FormatField::Hour2, true, true},
+        {"h", FormatField::Hour, true, true},
+        {"mm", FormatField::Minute2, true, true},
+        {"m", FormatField::Minute, true, true},
+        {"ss", FormatField::Second2, true, true},
+        {"s", FormatField::Second, true, true},
+        {"zzzzzzzzz", FormatField::Nanos9, true, true},
+        {"zzzzzz", FormatField::Micros6, true, true},
+        {"zzz", FormatField::Millis3, true, true},
+        {"z", FormatField::Millis, true, true},
+        {"AP", FormatField::AmPmUpper, true, false},
+        {"ap", FormatField::AmPmLower, true, false}};
+
+    if (format.substr(0, 2) == "''") {
+        const FormatToken token{FormatField::Literal, format.substr(0, 1)};
+        format.remove_prefix(2);
+        return token;
+    }
+    if (format.front() == '\'') {
+        format.remove_prefix(1);
+        const auto closing = format.find('\'');
+        if (closing == std::string_view::npos)
+            return FormatToken{FormatField::Literal, std::string_view{}};
+        const FormatToken token{FormatField::Literal,
+                                format.substr(0, closing)};
+        format.remove_prefix(closing + 1);
+        return token;
+    }
+    for (const auto& expression : expressions) {
+        if (kind == FormatKind::Elapsed ? !expression.elapsed
+            : kind == FormatKind::Time  ? !expression.time
+                                        : expression.time
+                                              && kind == FormatKind::Date)
+            continue;
+        if (format.substr(0, expression.pattern.size())
+            == expression.pattern) {
+            format.remove_prefix(expression.pattern.size());
+            return FormatToken{expression.field, expression.pattern};
+        }
+    }
+    const FormatToken token{FormatField::Literal, format.substr(0, 1)};
+    format.remove_prefix(1);
+    return token;
+}
+
+inline constexpr std::size_t max_field_size(FormatField field) noexcept
+{
+    switch (field) {
+    case FormatField::Literal:
+        return 0;
+    case FormatField::Year4:
+        return 11;
+    // Date accepts unnormalized months and days up to 255
+    case FormatField::Month2:
+    case FormatField::Month:
+    case FormatField::Day2:
+    case FormatField::Day:
+    case FormatField::Year2:
+    case FormatField::Millis:
+    case FormatField::Millis3:
+        return 3;
+    case FormatField::Micros6:
+        return 6;
+    case FormatField::Nanos9:
+        return 9;
+    default:
+        return 2;
+    }
+}
+
+inline constexpr FormatValues format_values(const Date& date) noexcept
+{
+    return FormatValues{static_cast<int>(date.year()),
+                        static_cast<unsigned>(date.month()),
+                        static_cast<unsigned>(date.day()),
+                        0,
+                        0,
+                        0,
+                        0};
+}
+
+inline constexpr FormatValues format_values(const TimeOfDay& time) noexcept
+{
+    return FormatValues{0,
+                        1,
+                        1,
+                        static_cast<long long>(time.hour().count()),
+                        static_cast<long long>(time.minute().count()),
+                        static_cast<long long>(time.second().count()),
+                        static_cast<long long>(time.millisecond().count())
+                            * 1'000'000};
+}
+
+template <typename Duration>
+inline constexpr FormatValues
+format_values(const BasicDateTime<Duration>& dt) noexcept
+{
+    using namespace std::chrono;
+    const auto time = dt.time();
+    return FormatValues{
+        static_cast<int>(dt.year()),
+        static_cast<unsigned>(dt.month()),
+        static_cast<unsigned>(dt.day()),
+        static_cast<long long>(dt.hour().count()),
+        static_cast<long long>(dt.minute().count()),
+        static_cast<long long>(dt.second().count()),
+        static_cast<long long>(
+            duration_cast<nanoseconds>(time - floor<seconds>(time)).count())};
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE char* write_field(char* out,
+                                 FormatField field,
+                                 const FormatValues& values,
+                                 bool twelve_hour) noexcept
+{
+    const long long hour{twelve_hour ? (values.hour + 11) % 12 + 1
+                                     : values.hour};
+    switch (field) {
+    case FormatField::Literal:
+        break;
+    case FormatField::Year4:
+        return write_padded(out, values.year, 4);
+    case FormatField::Year2:
+        return write_padded(out, values.year % 100, 2);
+    case FormatField::Month2:
+        return write_padded(out, values.month, 2);
+    case FormatField::Month:
+        return write_padded(out, values.month, 1);
+    case FormatField::Day2:
+        return write_padded(out, values.day, 2);
+    case FormatField::Day:
+        return write_padded(out, values.day, 1);
+    case FormatField::Hour2:
+        return write_padded(out, hour, 2);
+    case FormatField::Hour:
+        return write_padded(out, hour, 1);
+    case FormatField::Minute2:
+        return write_padded(out, values.minute, 2);
+    case FormatField::Minute:
+        return write_padded(out, values.minute, 1);
+    case FormatField::Second2:
+        return write_padded(out, values.second, 2);
+    case FormatField::Second:
+        return write_padded(out, values.second, 1);
+    case FormatField::Millis:
+        return write_padded(out, values.nanos / 1'000'000, 1);
+    case FormatField::Millis3:
+        return write_padded(out, values.nanos / 1'000'000, 3);
+    case FormatField::Micros6:
+        return write_padded(out, values.nanos / 1'000, 6);
+    case FormatField::Nanos9:
+        return write_padded(out, values.nanos, 9);
+    case FormatField::AmPmUpper:
+        *out++ = values.hour < 12 ? 'A' : 'P';
+        *out++ = 'M';
+        break;
+    case FormatField::AmPmLower:
+        *out++ = values.hour < 12 ? 'a' : 'p';
+        *out++ = 'm';
+        break;
+    }
+    return out;
+}
+
+DW_OUT_OF_LINE char* write_date(char* out, const Date& date) noexcept
+{
+    out = write_padded(out, static_cast<unsigned>(date.day()), 2);
+    *out++ = '.';
+    out = write_padded(out, static_cast<unsigned>(date.month()), 2);
+    *out++ = '.';
+    return write_padded(out, static_cast<int>(date.year()), 1);
+}
+
+#endif
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE char* write_text(char* out, std::string_view text) noexcept
+{
+    return std::copy(text.cbegin(), text.cend(), out);
+}
+
+#endif
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: FORMAT_H_B6LP9Z2C */
@@ -0,0 +1,371 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef FORMATTER_H_H6ZP1VQE
+#define FORMATTER_H_H6ZP1VQE
+
+#include "date_wrapper.h"
+#include <array>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#if !defined(DATE_WRAPPER_NO_FMT) && __has_include(<fmt/format.h>)
+#include <fmt/format.h>
+#define DATE_WRAPPER_HAS_FMT
+#endif
+
+/* std::formatter and fmt::formatter specializations for Date, DateTime,
+ * IsoDate, DateRange and DateTimeRange.
+ *
+ * The format spec uses the same expressions as to_string, i.e.
+ * std::format("{:yyyy-MM-dd hh:mm}", dt). Range values apply the spec to
+ * both ends and separate them with " - ". Empty spec produces the same
+ * output as operator<<. IsoDate accepts only empty spec and is formatted as
+ * ISO 8601 week date, i.e. "2019-W19-5".
+ *
+ * The spec is compiled once in parse() and values are written directly to
+ * the output iterator. fmt::formatter specializations are provided when
+ * <fmt/format.h> is available, unless DATE_WRAPPER_NO_FMT is defined.
+ */
+namespace dw::utils {
+
+/* Format spec compiled into expressions and literal text, that refers to
+ * the format string. */
+class FormatSpec {
+public:
+    static constexpr std::size_t capacity{32};
+
+    /* Compiles spec and returns false if it has too many expressions. */
+    constexpr bool compile(std::string_view spec, FormatKind kind) noexcept;
+
+    constexpr bool empty() const noexcept;
+
+    template <typename OutputIt>
+    OutputIt write(OutputIt out, const FormatValues& values) const;
+
+private:
+    std::array<FormatToken, capacity> tokens_{};
+    std::size_t size_{0};
+    bool twelve_hour_{false};
+};
+
+template <typename T> struct FormatTraits;
+
+/* Implements parse() and format() shared by std::formatter and
+ * fmt::formatter specializations. */
+template <typename T, typename Error> class Formatter {
+public:
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx) -> decltype(ctx.begin());
+
+    template <typename FormatContext>
+    auto format(const T& value, FormatContext& ctx) const
+        -> decltype(ctx.out());
+
+private:
+    FormatSpec spec_;
+};
+
+template <typename OutputIt>
+OutputIt write_chars(OutputIt out, const char* first, const char* last);
+
+template <typename OutputIt>
+OutputIt write_chars(OutputIt out, std::string_view text);
+
+template <> struct FormatTraits<Date> {
+    static constexpr FormatKind kind{FormatKind::Date};
+    static constexpr bool accepts_spec{true};
+
+    template <typename OutputIt>
+    static OutputIt
+    write(OutputIt out, const Date& date, const FormatSpec& spec);
+};
+
+template <typename Duration> struct FormatTraits<BasicDateTime<Duration>> {
+    static constexpr FormatKind kind{FormatKind::DateAndTime};
+    static constexpr bool accepts_spec{true};
+
+    template <typename OutputIt>
+    static OutputIt write(OutputIt out,
+                          const BasicDateTime<Duration>& dt,
+                          const FormatSpec& spec);
+};
+
+template <> struct FormatTraits<IsoDate> {
+    static constexpr FormatKind kind{FormatKind::Date};
+    static constexpr bool accepts_spec{false};
+
+    template <typename OutputIt>
+    static OutputIt
+    write(OutputIt out, const IsoDate& iso_date, const FormatSpec& spec);
+};
+
+template <> struct FormatTraits<DateRange> {
+    static constexpr FormatKind kind{FormatKind::Date};
+    static constexpr bool accepts_spec{true};
+
+    template <typename OutputIt>
+    static OutputIt
+    write(OutputIt out, const DateRange& range, const FormatSpec& spec);
+};
+
+template <> struct FormatTraits<DateTimeRange> {
+    static constexpr FormatKind kind{FormatKind::DateAndTime};
+    static constexpr bool accepts_spec{true};
+
+    template <typename OutputIt>
+    static OutputIt
+    write(OutputIt out, const DateTimeRange& range, const FormatSpec& spec);
+};
+
+// FormatSpec implementation
+
+inline constexpr bool FormatSpec::compile(std::string_view spec,
+                                          FormatKind kind) noexcept
+{
+    size_ = 0;
+    twelve_hour_ = false;
+    while (!spec.empty()) {
+        const auto token = next_format_token(spec, kind);
+        if (token.field == FormatField::Literal && token.text.empty())
+            continue;
+        if (size_ == capacity)
+            return false;
+        tokens_[size_++] = token;
+        twelve_hour_ = twelve_hour_ || token.field == FormatField::AmPmUpper
+                       || token.field == FormatField::AmPmLower;
+    }
+    return true;
+}
+
+inline constexpr bool FormatSpec::empty() const noexcept { return size_ == 0; }
+
+template <typename OutputIt>
+OutputIt FormatSpec::write(OutputIt out, const FormatValues& values) const
+{
+    char buffer[16];
+    for (std::size_t i = 0; i < size_; ++i) {
+        const auto& token = tokens_[i];
+        if (token.field == FormatField::Literal) {
+            out = write_chars(out, token.text);
+            continue;
+        }
+        out = write_chars(
+            out,
+            buffer,
+            write_field(buffer, token.field, values, twelve_hour_));
+    }
+    return out;
+}
+
+// Formatter implementation
+
+template <typename T, typename Error>
+template <typename ParseContext>
+constexpr auto Formatter<T, Error>::parse(ParseContext& ctx)
+    -> decltype(ctx.begin())
+{
+    auto first = ctx.begin();
+    auto last = first;
+    std::size_t size{0};
+    while (last != ctx.end() && *last != '}') {
+        ++last;
+        ++size;
+    }
+    if (size == 0)
+        return last;
+    if (!FormatTraits<T>::accepts_spec)
+        throw Error("format spec is not supported for this type");
+    if (!spec_.compile(std::string_view{&*first, size},
+                       FormatTraits<T>::kind))
+        throw Error("format spec has too many expressions");
+    return last;
+}
+
+template <typename T, typename Error>
+template <typename FormatContext>
+auto Formatter<T, Error>::format(const T& value, FormatContext& ctx) const
+    -> decltype(ctx.out())
+{
+    return FormatTraits<T>::write(ctx.out(), value, spec_);
+}
+
+template <typename OutputIt>
+OutputIt write_chars(OutputIt out, const char* first, const char* last)
+{
+    return std::copy(first, last, out);
+}
+
+template <typename OutputIt>
+OutputIt write_chars(OutputIt out, std::string_view text)
+{
+    return std::copy(text.cbegin(), text.cend(), out);
+}
+
+// FormatTraits implementation
+
+template <typename OutputIt>
+OutputIt FormatTraits<Date>::write(OutputIt out,
+                                   const Date& date,
+                                   const FormatSpec& spec)
+{
+    if (!spec.empty())
+        return spec.write(out, format_values(date));
+    char buffer[32];
+    return write_chars(out, buffer, write_date(buffer, date));
+}
+
+template <typename Duration>
+template <typename OutputIt>
+OutputIt
+FormatTraits<BasicDateTime<Duration>>::write(OutputIt out,
+                                             const BasicDateTime<Duration>& dt,
+                                             const FormatSpec& spec)
+{
+    if (!spec.empty())
+        return spec.write(out, format_values(dt));
+    char buffer[48];
+    return write_chars(out, buffer, write_date_time(buffer, dt));
+}
+
+template <typename OutputIt>
+OutputIt FormatTraits<IsoDate>::write(OutputIt out,
+                                      const IsoDate& iso_date,
+                                      const FormatSpec&)
+{
+    char buffer[32];
+    char* end = write_padded(buffer, static_cast<int>(iso_date.year()), 4);
+    end = write_text(end, "-W");
+    end = write_padded(end, iso_date.weeknum(), 2);
+    *end++ = '-';
+    end = write_padded(end, static_cast<int>(iso_date.weekday()) + 1, 1);
+    return write_chars(out, buffer, end);
+}
+
+template <typename OutputIt>
+OutputIt FormatTraits<DateRange>::write(OutputIt out,
+                                        const DateRange& range,
+                                        const FormatSpec& spec)
+{
+    if (!spec.empty()) {
+        out = spec.write(out, format_values(range.start()));
+        out = write_chars(out, std::string_view{" - "});
+        return spec.write(out, format_values(range.finish()));
+    }
+    char buffer[80];
+    char* end = write_text(buffer, "DateRange {");
+    end = write_date(end, range.start());
+    end = write_text(end, " - ");
+    end = write_date(end, range.finish());
+    end = write_text(end, "}");
+    return write_chars(out, buffer, end);
+}
+
+template <typename OutputIt>
+OutputIt FormatTraits<DateTimeRange>::write(OutputIt out,
+                                            const DateTimeRange& range,
+                                            const FormatSpec& spec)
+{
+    if (!spec.empty()) {
+        out = spec.write(out, format_values(range.start()));
+        out = write_chars(out, std::string_view{" - "});
+        return spec.write(out, format_values(range.finish()));
+    }
+    char buffer[112];
+    char* end = write_text(buffer, "DateTimeRange {");
+    end = write_date_time(end, range.start());
+    end = write_text(end, ", ");
+    end = write_date_time(end, range.finish());
+    end = write_text(end, "}");
+    return write_chars(out, buffer, end);
+}
+
+} // namespace dw::utils
+
+#if defined(__cpp_lib_format)
+
+namespace std {
+
+template <>
+struct formatter<dw::Date, char>
+    : dw::utils::Formatter<dw::Date, std::format_error> {
+};
+
+template <typename Duration>
+struct formatter<dw::BasicDateTime<Duration>, char>
+    : dw::utils::Formatter<dw::BasicDateTime<Duration>, std::format_error> {
+};
+
+template <>
+struct formatter<dw::IsoDate, char>
+    : dw::utils::Formatter<dw::IsoDate, std::format_error> {
+};
+
+template <>
+struct formatter<dw::DateRange, char>
+    : dw::utils::Formatter<dw::DateRange, std::format_error> {
+};
+
+template <>
+struct formatter<dw::DateTimeRange, char>
+    : dw::utils::Formatter<dw::DateTimeRange, std::format_error> {
+};
+
+} // namespace std
+
+#endif
+
+#ifdef DATE_WRAPPER_HAS_FMT
+
+namespace fmt {
+
+template <>
+struct formatter<dw::Date, char>
+    : dw::utils::Formatter<dw::Date, fmt::format_error> {
+};
+
+template <typename Duration>
+struct formatter<dw::BasicDateTime<Duration>, char>
+    : dw::utils::Formatter<dw::BasicDateTime<Duration>, fmt::format_error> {
+};
+
+template <>
+struct formatter<dw::IsoDate, char>
+    : dw::utils::Formatter<dw::IsoDate, fmt::format_error> {
+};
+
+template <>
+struct formatter<dw::DateRange, char>
+    : dw::utils::Formatter<dw::DateRange, fmt::format_error> {
+};
+
+template <>
+struct formatter<dw::DateTimeRange, char>
+    : dw::utils::Formatter<dw::DateTimeRange, fmt::format_error> {
+};
+
+} // namespace fmt
+
+#endif
+
+#endif /* end of include guard: FORMATTER_H_H6ZP1VQE */
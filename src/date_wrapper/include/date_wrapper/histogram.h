@@ -0,0 +1,329 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef HISTOGRAM_H_Q8V2NDKA
+#define HISTOGRAM_H_Q8V2NDKA
+
+#include "parallel.h"
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace dw {
+
+/* Holds per-bucket event counts or weight sums for a DateRange split into
+ * calendar buckets.
+ *
+ * Both range endpoints are inclusive. First and last IsoWeek and Month
+ * buckets cover whole calendar weeks and months, even if the range starts or
+ * ends in the middle of one; only events that fall into the range itself are
+ * counted, the rest are accounted for by dropped().
+ */
+class CalendarHistogram {
+public:
+    CalendarHistogram(const DateRange& range, BucketUnit unit);
+
+    BucketUnit unit() const noexcept;
+
+    DateRange range() const noexcept;
+
+    /* Returns number of buckets. */
+    std::size_t size() const noexcept;
+
+    /* Returns index of bucket that contains the date or size() if the date is
+     * outside of histogram range. */
+    std::size_t bucket_index(const Date& date) const noexcept;
+
+    /* Returns DateRange covered by bucket with given index. */
+    DateRange bucket(std::size_t index) const noexcept;
+
+    double value(std::size_t index) const noexcept;
+
+    const std::vector<double>& values() const noexcept;
+
+    /* Returns number of events that were outside of histogram range. */
+    std::uint64_t dropped() const noexcept;
+
+    void add(const DateTime& event, double weight = 1.0) noexcept;
+
+    void add(span<const DateTime> events) noexcept;
+
+    /* Throws std::invalid_argument if events and weights sizes differ. */
+    void add(span<const DateTime> events, span<const double> weights);
+
+    /* Adds bucket values of other histogram to this one.
+     * Throws std::invalid_argument if histograms have different range or unit.
+     */
+    void merge(const CalendarHistogram& other);
+
+private:
+    DateRange range_;
+    BucketUnit unit_;
+    long long first_day_;
+    long long last_day_;
+    long long origin_;
+    // Serial day of the first day of every Month bucket
+    std::vector<long long> month_starts_;
+    std::vector<double> values_;
+    std::uint64_t dropped_{0};
+
+    /* Same as bucket_index() for a serial day, without calendar
+     * conversions. */
+    std::size_t day_bucket(long long day) const noexcept;
+};
+
+/* Builds histogram of events that fall into the range.
+ *
+ * Events are split into contiguous chunks, each chunk is counted into a
+ * thread-local histogram, and local histograms are merged at the end.
+ * Concurrency of 0 means std::thread::hardware_concurrency(). Small inputs
+ * are processed on the calling thread.
+ */
+CalendarHistogram make_histogram(span<const DateTime> events,
+                                 const DateRange& range,
+                                 BucketUnit unit,
+                                 unsigned concurrency = 0);
+
+/* Same as above, but each event contributes its weight instead of 1.
+ * Throws std::invalid_argument if events and weights sizes differ. */
+CalendarHistogram make_histogram(span<const DateTime> events,
+                                 span<const double> weights,
+                                 const DateRange& range,
+                                 BucketUnit unit,
+                                 unsigned concurrency = 0);
+
+// CalendarHistogram implementation
+
+inline CalendarHistogram::CalendarHistogram(const DateRange& range,
+                                            BucketUnit unit)
+    : range_{range.start() <= range.finish()
+                 ? range
+                 : DateRange{range.finish(), range.start()}}
+    , unit_{unit}
+    , first_day_{utils::serial_day(range_.start())}
+    , last_day_{utils::serial_day(range_.finish())}
+    , origin_{0}
+{
+    switch (unit_) {
+    case BucketUnit::Day:
+        origin_ = first_day_;
+        break;
+    case BucketUnit::IsoWeek:
+        origin_ = utils::serial_day(
+            prev_weekday(range_.start(), Weekday::Monday));
+        break;
+    case BucketUnit::Month: {
+        const Date first{range_.start().year(), range_.start().month(), Day{1}};
+        const long long months = utils::month_index(range_.finish())
+                                 - utils::month_index(range_.start()) + 1;
+        month_starts_.reserve(static_cast<std::size_t>(months));
+        for (long long i = 0; i < months; ++i)
+            month_starts_.push_back(utils::serial_day(first + Months{i}));
+        break;
+    }
+    }
+    values_.resize(day_bucket(last_day_) + 1);
+}
+
+inline BucketUnit CalendarHistogram::unit() const noexcept { return unit_; }
+
+inline DateRange CalendarHistogram::range() const noexcept { return range_; }
+
+inline std::size_t CalendarHistogram::size() const noexcept
+{
+    return values_.size();
+}
+
+inline std::size_t CalendarHistogram::day_bucket(long long day) const noexcept
+{
+    if (day < first_day_ || day > last_day_)
+        return values_.size();
+    switch (unit_) {
+    case BucketUnit::Day:
+        return static_cast<std::size_t>(day - origin_);
+    case BucketUnit::IsoWeek:
+        return static_cast<std::size_t>((day - origin_) / 7);
+    case BucketUnit::Month: {
+        // Average Gregorian month is 146097 / 4800 days, the guess is off by
+        // at most one bucket and is corrected by the stored month starts
+        const std::size_t last = month_starts_.size() - 1;
+        auto index = std::min(
+            last,
+            static_cast<std::size_t>((day - month_starts_[0]) * 4800 / 146097));
+        if (month_starts_[index] > day)
+            --index;
+        else if (index < last && month_starts_[index + 1] <= day)
+            ++index;
+        return index;
+    }
+    }
+    return values_.size();
+}
+
+inline std::size_t CalendarHistogram::bucket_index(const Date& date) const
+    noexcept
+{
+    return day_bucket(utils::serial_day(date));
+}
+
+inline DateRange CalendarHistogram::bucket(std::size_t index) const noexcept
+{
+    const auto offset = static_cast<long long>(index);
+    switch (unit_) {
+    case BucketUnit::Day: {
+        const Date day{range_.start() + Days{offset}};
+        return DateRange{day, day};
+    }
+    case BucketUnit::IsoWeek: {
+        const Date monday{prev_weekday(range_.start(), Weekday::Monday)
+                          + Weeks{offset}};
+        return DateRange{monday, monday + Days{6}};
+    }
+    case BucketUnit::Month: {
+        const Date first{range_.start().year(), range_.start().month(), Day{1}};
+        const Date month_start{first + Months{offset}};
+        return DateRange{month_start, last_day_of_month(month_start)};
+    }
+    }
+    return range_;
+}
+
+inline double CalendarHistogram::value(std::size_t index) const noexcept
+{
+    return values_[index];
+}
+
+inline const std::vector<double>& CalendarHistogram::values() const noexcept
+{
+    return values_;
+}
+
+inline std::uint64_t CalendarHistogram::dropped() const noexcept
+{
+    return dropped_;
+}
+
+inline void CalendarHistogram::add(const DateTime& event,
+                                   double weight) noexcept
+{
+    // Day count is stored in DateTime, no year/month/day round trip
+    const std::size_t index
+        = day_bucket(event.day_point().time_since_epoch().count());
+    if (index == values_.size()) {
+        ++dropped_;
+        return;
+    }
+    values_[index] += weight;
+}
+
+inline void CalendarHistogram::add(span<const DateTime> events) noexcept
+{
+    for (const auto& event : events)
+        add(event);
+}
+
+inline void CalendarHistogram::add(span<const DateTime> events,
+                                   span<const double> weights)
+{
+    if (events.size() != weights.size())
+        throw std::invalid_argument("events and weights sizes differ");
+    for (std::size_t i = 0; i < events.size(); ++i)
+        add(events[i], weights[i]);
+}
+
+inline void CalendarHistogram::merge(const CalendarHistogram& other)
+{
+    if (range_ != other.range_ || unit_ != other.unit_)
+        throw std::invalid_argument("histogram layouts differ");
+    for (std::size_t i = 0; i < values_.size(); ++i)
+        values_[i] += other.values_[i];
+    dropped_ += other.dropped_;
+}
+
+namespace detail {
+
+template <typename AddChunk>
+CalendarHistogram build_histogram(std::size_t size,
+                                  const DateRange& range,
+                                  BucketUnit unit,
+                                  unsigned concurrency,
+                                  AddChunk add_chunk)
+{
+    std::vector<CalendarHistogram> locals(
+        concurrency == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                         : concurrency,
+        CalendarHistogram{range, unit});
+    const std::size_t chunks = utils::for_each_chunk(
+        size,
+        static_cast<unsigned>(locals.size()),
+        [&](std::size_t chunk, std::size_t first, std::size_t last) {
+            add_chunk(locals[chunk], first, last);
+        });
+    for (std::size_t i = 1; i < chunks; ++i)
+        locals.front().merge(locals[i]);
+    return std::move(locals.front());
+}
+
+} // namespace detail
+
+inline CalendarHistogram make_histogram(span<const DateTime> events,
+                                        const DateRange& range,
+                                        BucketUnit unit,
+                                        unsigned concurrency)
+{
+    return detail::build_histogram(
+        events.size(),
+        range,
+        unit,
+        concurrency,
+        [events](
+            CalendarHistogram& local, std::size_t first, std::size_t last) {
+            local.add(events.subspan(first, last - first));
+        });
+}
+
+inline CalendarHistogram make_histogram(span<const DateTime> events,
+                                        span<const double> weights,
+                                        const DateRange& range,
+                                        BucketUnit unit,
+                                        unsigned concurrency)
+{
+    if (events.size() != weights.size())
+        throw std::invalid_argument("events and weights sizes differ");
+    return detail::build_histogram(
+        events.size(),
+        range,
+        unit,
+        concurrency,
+        [events, weights](
+            CalendarHistogram& local, std::size_t first, std::size_t last) {
+            local.add(events.subspan(first, last - first),
+                      weights.subspan(first, last - first));
+        });
+}
+
+} // namespace dw
+
+#endif /* end of include guard: HISTOGRAM_H_Q8V2NDKA */
@@ -0,0 +1,367 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef INSTRUMENTATION_H_W5YH2K3P
+#define INSTRUMENTATION_H_W5YH2K3P
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef DATE_WRAPPER_INSTRUMENTATION
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+/* Opt-in hot path instrumentation.
+ *
+ * When DATE_WRAPPER_INSTRUMENTATION is defined (see ENABLE_INSTRUMENTATION
+ * CMake option), library entry points count their invocations and sample
+ * their latency into per-thread blocks that are aggregated by snapshot().
+ * Otherwise instrumentation macros expand to nothing and snapshot() always
+ * returns zeroes.
+ */
+namespace dw::instrumentation {
+
+enum class Counter : std::size_t {
+    ToStringDate,
+    ToStringDateTime,
+    ToStringDateRange,
+    ToStringDateTimeRange,
+    LocalTime,
+    Normalize,
+    MonthClamp,
+    YearClamp
+};
+
+inline constexpr std::size_t counter_count{8};
+
+/* Latency of every sampling_period-th call of a timed entry point is
+ * recorded. */
+inline constexpr unsigned sampling_period{64};
+
+/* Bucket i holds samples with latency in [2^i, 2^(i+1)) nanoseconds. */
+inline constexpr std::size_t latency_buckets{32};
+
+#ifdef DATE_WRAPPER_INSTRUMENTATION
+inline constexpr bool enabled{true};
+#else
+inline constexpr bool enabled{false};
+#endif
+
+struct LatencyHistogram {
+    std::array<std::uint64_t, latency_buckets> buckets{};
+    std::uint64_t samples{0};
+    std::uint64_t total_ns{0};
+};
+
+struct Snapshot {
+    std::array<std::uint64_t, counter_count> counters{};
+    std::array<LatencyHistogram, counter_count> latencies{};
+
+    std::uint64_t count(Counter counter) const noexcept;
+
+    const LatencyHistogram& latency(Counter counter) const noexcept;
+};
+
+/* Returns counters accumulated by all threads, including finished ones. */
+Snapshot snapshot();
+
+/* Resets all counters and histograms. Calls that run concurrently with
+ * reset() might or might not be accounted for. */
+void reset();
+
+namespace detail {
+
+constexpr bool is_constant_evaluated() noexcept;
+
+#ifdef DATE_WRAPPER_INSTRUMENTATION
+
+struct Block {
+    std::array<std::atomic<std::uint64_t>, counter_count> counters{};
+    std::array<std::array<std::atomic<std::uint64_t>, latency_buckets>,
+               counter_count>
+        latency{};
+    std::array<std::atomic<std::uint64_t>, counter_count> latency_total_ns{};
+    unsigned ticks{0};
+};
+
+class Registry {
+public:
+    void attach(Block* block);
+
+    void detach(Block* block);
+
+    Snapshot collect();
+
+    void reset();
+
+private:
+    std::mutex mutex_;
+    std::vector<Block*> live_;
+    Block retired_;
+};
+
+Registry& registry();
+
+Block& local_block();
+
+/* Returns block of the calling thread or nullptr when it can't be
+ * registered; hooks run inside noexcept functions and drop the event. */
+Block* try_local_block() noexcept;
+
+void count(Counter counter) noexcept;
+
+class ScopedLatency {
+public:
+    explicit ScopedLatency(Counter counter) noexcept;
+
+    ~ScopedLatency();
+
+    ScopedLatency(const ScopedLatency&) = delete;
+
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    Counter counter_;
+    Block* block_;
+    bool sampled_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif
+
+} // namespace detail
+
+} // namespace dw::instrumentation
+
+#ifdef DATE_WRAPPER_INSTRUMENTATION
+
+#define DW_INSTRUMENT_COUNT(counter)                                           \
+    ::dw::instrumentation::detail::count(                                      \
+        ::dw::instrumentation::Counter::counter)
+
+/* Counts call and samples latency of the enclosing scope. */
+#define DW_INSTRUMENT_SCOPE(counter)                                           \
+    const ::dw::instrumentation::detail::ScopedLatency                         \
+        dw_instrument_scope_##counter                                          \
+    {                                                                          \
+        ::dw::instrumentation::Counter::counter                                \
+    }
+
+/* Counts call from constexpr function unless it's evaluated at compile time.
+ */
+#define DW_INSTRUMENT_CONSTEXPR_COUNT(counter)                                 \
+    do {                                                                       \
+        if (!::dw::instrumentation::detail::is_constant_evaluated())           \
+            DW_INSTRUMENT_COUNT(counter);                                      \
+    } while (false)
+
+#else
+
+#define DW_INSTRUMENT_COUNT(counter) static_cast<void>(0)
+#define DW_INSTRUMENT_SCOPE(counter) static_cast<void>(0)
+#define DW_INSTRUMENT_CONSTEXPR_COUNT(counter) static_cast<void>(0)
+
+#endif
+
+namespace dw::instrumentation {
+
+// Snapshot implementation
+
+inline std::uint64_t Snapshot::count(Counter counter) const noexcept
+{
+    return counters[static_cast<std::size_t>(counter)];
+}
+
+inline const LatencyHistogram& Snapshot::latency(Counter counter) const
+    noexcept
+{
+    return latencies[static_cast<std::size_t>(counter)];
+}
+
+#ifdef DATE_WRAPPER_INSTRUMENTATION
+
+inline Snapshot snapshot() { return detail::registry().collect(); }
+
+inline void reset() { detail::registry().reset(); }
+
+#else
+
+inline Snapshot snapshot() { return Snapshot{}; }
+
+inline void reset() { }
+
+#endif
+
+namespace detail {
+
+inline constexpr bool is_constant_evaluated() noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__)                                  \
+    || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    return __builtin_is_constant_evaluated();
+#else
+    // Unable to tell, so constexpr paths are never instrumented
+    return true;
+#endif
+}
+
+#ifdef DATE_WRAPPER_INSTRUMENTATION
+
+inline void add_block(Snapshot& snapshot, const Block& block)
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    for (std::size_t i = 0; i < counter_count; ++i) {
+        snapshot.counters[i] += block.counters[i].load(relaxed);
+        auto& latency = snapshot.latencies[i];
+        for (std::size_t b = 0; b < latency_buckets; ++b) {
+            const auto samples = block.latency[i][b].load(relaxed);
+            latency.buckets[b] += samples;
+            latency.samples += samples;
+        }
+        latency.total_ns += block.latency_total_ns[i].load(relaxed);
+    }
+}
+
+inline void clear_block(Block& block)
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    for (std::size_t i = 0; i < counter_count; ++i) {
+        block.counters[i].store(0, relaxed);
+        for (auto& bucket : block.latency[i])
+            bucket.store(0, relaxed);
+        block.latency_total_ns[i].store(0, relaxed);
+    }
+}
+
+inline void Registry::attach(Block* block)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    live_.push_back(block);
+}
+
+inline void Registry::detach(Block* block)
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (std::size_t i = 0; i < counter_count; ++i) {
+        retired_.counters[i].fetch_add(block->counters[i].load(relaxed),
+                                       relaxed);
+        for (std::size_t b = 0; b < latency_buckets; ++b)
+            retired_.latency[i][b].fetch_add(
+                block->latency[i][b].load(relaxed), relaxed);
+        retired_.latency_total_ns[i].fetch_add(
+            block->latency_total_ns[i].load(relaxed), relaxed);
+    }
+    live_.erase(std::find(live_.begin(), live_.end(), block));
+}
+
+inline Snapshot Registry::collect()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    Snapshot result;
+    add_block(result, retired_);
+    for (const Block* block : live_)
+        add_block(result, *block);
+    return result;
+}
+
+inline void Registry::reset()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    clear_block(retired_);
+    for (Block* block : live_)
+        clear_block(*block);
+}
+
+inline Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+inline Block& local_block()
+{
+    struct ThreadBlock {
+        ThreadBlock() { registry().attach(&block); }
+        ~ThreadBlock() { registry().detach(&block); }
+        Block block;
+    };
+    thread_local ThreadBlock thread_block;
+    return thread_block.block;
+}
+
+inline Block* try_local_block() noexcept
+{
+    try {
+        return &local_block();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+inline void count(Counter counter) noexcept
+{
+    if (Block* block = try_local_block())
+        block->counters[static_cast<std::size_t>(counter)].fetch_add(
+            1, std::memory_order_relaxed);
+}
+
+inline ScopedLatency::ScopedLatency(Counter counter) noexcept
+    : counter_{counter}
+    , block_{try_local_block()}
+    , sampled_{block_ != nullptr && ++block_->ticks % sampling_period == 0}
+{
+    count(counter_);
+    if (sampled_)
+        start_ = std::chrono::steady_clock::now();
+}
+
+inline ScopedLatency::~ScopedLatency()
+{
+    if (!sampled_)
+        return;
+    using namespace std::chrono;
+    const auto elapsed = static_cast<std::uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now() - start_).count());
+    std::size_t bucket{0};
+    while (bucket + 1 < latency_buckets && (elapsed >> (bucket + 1)) != 0)
+        ++bucket;
+    const auto index = static_cast<std::size_t>(counter_);
+    block_->latency[index][bucket].fetch_add(1, std::memory_order_relaxed);
+    block_->latency_total_ns[index].fetch_add(elapsed,
+                                              std::memory_order_relaxed);
+}
+
+#endif
+
+} // namespace detail
+
+} // namespace dw::instrumentation
+
+#endif /* end of include guard: INSTRUMENTATION_H_W5YH2K3P */
@@ -0,0 +1,188 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef IO_H_V4HT1S8G
+#define IO_H_V4HT1S8G
+
+#include "core.h"
+#include "format.h"
+#include "range.h"
+#include <algorithm>
+#include <ios>
+#include <ostream>
+#include <type_traits>
+
+namespace dw {
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Year& year);
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Month& month);
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Day& day);
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Date& date);
+
+template <class CharT, class Traits, typename Duration>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os,
+           const BasicDateTime<Duration>& dt);
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const DateRange& ds);
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const DateTimeRange& span);
+
+namespace utils {
+
+/* Inserts preformatted chars into the stream with a single sputn call. */
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+write_to_stream(std::basic_ostream<CharT, Traits>& os,
+                const char* first,
+                const char* last);
+
+} // namespace utils
+
+// Year, Month and Day implementation
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Year& year)
+{
+    os << "Year{" << static_cast<int>(year);
+    return os;
+}
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Month& month)
+{
+    os << "Month{" << static_cast<unsigned>(month) << "}";
+    return os;
+}
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Day& day)
+{
+    os << "Day{" << static_cast<unsigned>(day) << "}";
+    return os;
+}
+
+// Date implementation
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const Date& date)
+{
+    char buffer[32];
+    return utils::write_to_stream(
+        os, buffer, utils::write_date(buffer, date));
+}
+
+// BasicDateTime implementation
+
+template <class CharT, class Traits, typename Duration>
+inline std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os,
+           const BasicDateTime<Duration>& dt)
+{
+    char buffer[48];
+    return utils::write_to_stream(
+        os, buffer, utils::write_date_time(buffer, dt));
+}
+
+// DateRange implementation
+
+template <class CharT, class Traits>
+inline std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const DateRange& ds)
+{
+    using namespace utils;
+    char buffer[80];
+    char* out = write_text(buffer, "DateRange {");
+    out = write_date(out, ds.start());
+    out = write_text(out, " - ");
+    out = write_date(out, ds.finish());
+    out = write_text(out, "}");
+    return write_to_stream(os, buffer, out);
+}
+
+// DateTimeRange implementation
+
+template <class CharT, class Traits>
+inline std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os, const DateTimeRange& span)
+{
+    using namespace utils;
+    char buffer[112];
+    char* out = write_text(buffer, "DateTimeRange {");
+    out = write_date_time(out, span.start());
+    out = write_text(out, ", ");
+    out = write_date_time(out, span.finish());
+    out = write_text(out, "}");
+    return write_to_stream(os, buffer, out);
+}
+
+namespace utils {
+
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>&
+write_to_stream(std::basic_ostream<CharT, Traits>& os,
+                const char* first,
+                const char* last)
+{
+    const typename std::basic_ostream<CharT, Traits>::sentry sentry{os};
+    if (!sentry)
+        return os;
+    const std::streamsize size = last - first;
+    std::streamsize written{0};
+    if constexpr (std::is_same_v<CharT, char>) {
+        written = os.rdbuf()->sputn(first, size);
+    }
+    else {
+        CharT widened[128];
+        std::transform(
+            first, last, widened, [&os](char ch) { return os.widen(ch); });
+        written = os.rdbuf()->sputn(widened, size);
+    }
+    if (written != size)
+        os.setstate(std::ios_base::badbit);
+    os.width(0);
+    return os;
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: IO_H_V4HT1S8G */
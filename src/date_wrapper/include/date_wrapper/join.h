@@ -0,0 +1,155 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef JOIN_H_K5VC8EYP
+#define JOIN_H_K5VC8EYP
+
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dw {
+
+/* Calls fn(i, j) for every pair of left[i] and right[j] that overlap, see
+ * overlaps().
+ *
+ * Both sides are sorted by start and swept once while ranges that are still
+ * open on each side are kept aside, so for k pairs the cost is
+ * O(n log n + m log m + k) instead of O(n * m) of nested loops. Pairs are
+ * emitted in order of the later start of the two ranges.
+ */
+template <typename Fn>
+void overlap_join(span<const DateTimeRange> left,
+                  span<const DateTimeRange> right,
+                  Fn fn);
+
+/* Returns index pairs (i, j) of left[i] and right[j] that overlap. */
+std::vector<std::pair<std::size_t, std::size_t>>
+overlap_join(span<const DateTimeRange> left, span<const DateTimeRange> right);
+
+namespace detail {
+
+/* Bounds stay DateTime, which compares as day count plus time of day, so
+ * ordering is exact at any precision and for every representable year. */
+struct JoinInterval {
+    DateTime start;
+    DateTime finish;
+    std::size_t index;
+};
+
+/* Returns non-empty canonical ranges sorted by start. */
+std::vector<JoinInterval> sorted_intervals(span<const DateTimeRange> ranges);
+
+/* Drops open intervals that finish by start and calls emit(index) for the
+ * rest. */
+template <typename Emit>
+void sweep_open(std::vector<JoinInterval>& open,
+                const DateTime& start,
+                Emit emit);
+
+} // namespace detail
+
+// Overlap join implementation
+
+template <typename Fn>
+void overlap_join(span<const DateTimeRange> left,
+                  span<const DateTimeRange> right,
+                  Fn fn)
+{
+    const auto lhs = detail::sorted_intervals(left);
+    const auto rhs = detail::sorted_intervals(right);
+    std::vector<detail::JoinInterval> open_left;
+    std::vector<detail::JoinInterval> open_right;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    // Interval that starts next overlaps every open interval of other side
+    while (i < lhs.size() || j < rhs.size()) {
+        if (j == rhs.size()
+            || (i < lhs.size() && lhs[i].start <= rhs[j].start)) {
+            const auto& next = lhs[i++];
+            detail::sweep_open(open_right, next.start, [&](std::size_t other) {
+                fn(next.index, other);
+            });
+            open_left.push_back(next);
+        } else {
+            const auto& next = rhs[j++];
+            detail::sweep_open(open_left, next.start, [&](std::size_t other) {
+                fn(other, next.index);
+            });
+            open_right.push_back(next);
+        }
+    }
+}
+
+inline std::vector<std::pair<std::size_t, std::size_t>>
+overlap_join(span<const DateTimeRange> left, span<const DateTimeRange> right)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    overlap_join(left, right, [&pairs](std::size_t i, std::size_t j) {
+        pairs.emplace_back(i, j);
+    });
+    return pairs;
+}
+
+namespace detail {
+
+inline std::vector<JoinInterval>
+sorted_intervals(span<const DateTimeRange> ranges)
+{
+    std::vector<JoinInterval> intervals;
+    intervals.reserve(ranges.size());
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        if (empty(ranges[i]))
+            continue;
+        const DateTimeRange range{canonical(ranges[i])};
+        intervals.push_back(JoinInterval{range.start(), range.finish(), i});
+    }
+    std::sort(intervals.begin(),
+              intervals.end(),
+              [](const JoinInterval& lhs, const JoinInterval& rhs) {
+                  return lhs.start < rhs.start;
+              });
+    return intervals;
+}
+
+template <typename Emit>
+void sweep_open(std::vector<JoinInterval>& open,
+                const DateTime& start,
+                Emit emit)
+{
+    for (std::size_t k = 0; k < open.size();) {
+        if (open[k].finish <= start) {
+            open[k] = open.back();
+            open.pop_back();
+        } else {
+            emit(open[k++].index);
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace dw
+
+#endif /* end of include guard: JOIN_H_K5VC8EYP */
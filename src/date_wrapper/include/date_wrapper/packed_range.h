@@ -0,0 +1,312 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef PACKED_RANGE_H_D3RV6KWA
+#define PACKED_RANGE_H_D3RV6KWA
+
+#include "range.h"
+#include "span.h"
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace dw {
+
+/* DateTimeRange with whole-second endpoints packed into 8 bytes: start as
+ * 32-bit unsigned seconds since 1970-01-01T00:00:00 and length as 32-bit
+ * unsigned seconds.
+ *
+ * Start is in [1970-01-01T00:00:00, 2106-02-07T06:28:15] and length is below
+ * 2^32 seconds, about 136 years. Ranges within these limits, with whole
+ * seconds and start not later than finish, convert to and from
+ * DateTimeRange without loss. As interval operations of DateTimeRange, the
+ * range is treated as half-open [start, finish).
+ */
+class PackedDateTimeRange {
+public:
+    /* Returns true if range converts to PackedDateTimeRange without loss. */
+    static constexpr bool representable(const DateTimeRange& range) noexcept;
+
+    constexpr PackedDateTimeRange(std::uint32_t start_seconds,
+                                  std::uint32_t length_seconds) noexcept;
+
+    /* Throws std::out_of_range if range is not representable(). */
+    constexpr explicit PackedDateTimeRange(const DateTimeRange& range);
+
+    constexpr std::uint32_t start_seconds() const noexcept;
+
+    constexpr std::uint32_t length_seconds() const noexcept;
+
+    constexpr DateTime start() const noexcept;
+
+    constexpr DateTime finish() const noexcept;
+
+    constexpr std::chrono::seconds duration() const noexcept;
+
+    constexpr DateTimeRange to_range() const noexcept;
+
+private:
+    std::uint32_t start_;
+    std::uint32_t length_;
+};
+
+constexpr bool operator==(const PackedDateTimeRange& lhs,
+                          const PackedDateTimeRange& rhs) noexcept;
+
+constexpr bool operator!=(const PackedDateTimeRange& lhs,
+                          const PackedDateTimeRange& rhs) noexcept;
+
+constexpr bool contains(const PackedDateTimeRange& range,
+                        const DateTime& dt) noexcept;
+
+constexpr bool overlaps(const PackedDateTimeRange& lhs,
+                        const PackedDateTimeRange& rhs) noexcept;
+
+/* Batch checks below have no branches in the loop over ranges, so compilers
+ * vectorize them. Flags are stored as 0 or 1.
+ * Throw std::invalid_argument if sizes of ranges and flags differ. */
+
+/* Stores contains(ranges[i], dt) into flags[i]. */
+void contains(span<const PackedDateTimeRange> ranges,
+              const DateTime& dt,
+              span<std::uint8_t> flags);
+
+/* Stores overlaps(ranges[i], probe) into flags[i]. */
+void overlaps(span<const PackedDateTimeRange> ranges,
+              const PackedDateTimeRange& probe,
+              span<std::uint8_t> flags);
+
+std::size_t count_containing(span<const PackedDateTimeRange> ranges,
+                             const DateTime& dt) noexcept;
+
+std::size_t count_overlapping(span<const PackedDateTimeRange> ranges,
+                              const PackedDateTimeRange& probe) noexcept;
+
+namespace utils {
+
+/* Returns floor of seconds since 1970-01-01T00:00:00. */
+constexpr std::int64_t epoch_seconds(const DateTime& dt) noexcept;
+
+constexpr std::chrono::time_point<std::chrono::system_clock,
+                                  std::chrono::seconds>
+from_epoch_seconds(std::int64_t seconds) noexcept;
+
+} // namespace utils
+
+// PackedDateTimeRange implementation
+
+inline constexpr bool
+PackedDateTimeRange::representable(const DateTimeRange& range) noexcept
+{
+    using std::chrono::seconds;
+    const auto start = to_time_point<seconds>(range.start());
+    const auto finish = to_time_point<seconds>(range.finish());
+    constexpr auto max = std::numeric_limits<std::uint32_t>::max();
+    const std::int64_t start_seconds = start.time_since_epoch().count();
+    const std::int64_t length = (finish - start).count();
+    return DateTime{start} == range.start()
+           && DateTime{finish} == range.finish() && start_seconds >= 0
+           && start_seconds <= max && length >= 0 && length <= max;
+}
+
+inline constexpr PackedDateTimeRange::PackedDateTimeRange(
+    std::uint32_t start_seconds, std::uint32_t length_seconds) noexcept
+    : start_{start_seconds}
+    , length_{length_seconds}
+{
+}
+
+inline constexpr PackedDateTimeRange::PackedDateTimeRange(
+    const DateTimeRange& range)
+    : start_{0}
+    , length_{0}
+{
+    if (!representable(range))
+        throw std::out_of_range("range is not representable when packed");
+    start_ = static_cast<std::uint32_t>(utils::epoch_seconds(range.start()));
+    length_ = static_cast<std::uint32_t>(
+        range.duration<std::chrono::seconds>().count());
+}
+
+inline constexpr std::uint32_t PackedDateTimeRange::start_seconds() const
+    noexcept
+{
+    return start_;
+}
+
+inline constexpr std::uint32_t PackedDateTimeRange::length_seconds() const
+    noexcept
+{
+    return length_;
+}
+
+inline constexpr DateTime PackedDateTimeRange::start() const noexcept
+{
+    return DateTime{utils::from_epoch_seconds(start_)};
+}
+
+inline constexpr DateTime PackedDateTimeRange::finish() const noexcept
+{
+    return DateTime{
+        utils::from_epoch_seconds(std::int64_t{start_} + length_)};
+}
+
+inline constexpr std::chrono::seconds PackedDateTimeRange::duration() const
+    noexcept
+{
+    return std::chrono::seconds{length_};
+}
+
+inline constexpr DateTimeRange PackedDateTimeRange::to_range() const noexcept
+{
+    return DateTimeRange{start(), finish()};
+}
+
+inline constexpr bool operator==(const PackedDateTimeRange& lhs,
+                                 const PackedDateTimeRange& rhs) noexcept
+{
+    return lhs.start_seconds() == rhs.start_seconds()
+           && lhs.length_seconds() == rhs.length_seconds();
+}
+
+inline constexpr bool operator!=(const PackedDateTimeRange& lhs,
+                                 const PackedDateTimeRange& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+inline constexpr bool contains(const PackedDateTimeRange& range,
+                               const DateTime& dt) noexcept
+{
+    // Both bounds in one comparison: instants before start wrap around
+    const std::int64_t offset
+        = utils::epoch_seconds(dt) - std::int64_t{range.start_seconds()};
+    return static_cast<std::uint64_t>(offset) < range.length_seconds();
+}
+
+inline constexpr bool overlaps(const PackedDateTimeRange& lhs,
+                               const PackedDateTimeRange& rhs) noexcept
+{
+    // Distance from the earlier start must be below its length; all
+    // arithmetic stays in 32 bits, so it maps to SIMD lanes without 64-bit
+    // compares
+    const std::uint32_t distance = lhs.start_seconds() - rhs.start_seconds();
+    const bool lhs_later = lhs.start_seconds() >= rhs.start_seconds();
+    return ((lhs_later & (distance < rhs.length_seconds()))
+            | (!lhs_later & (0u - distance < lhs.length_seconds())))
+           & (lhs.length_seconds() != 0) & (rhs.length_seconds() != 0);
+}
+
+namespace detail {
+
+/* contains() for instant given as 32-bit epoch seconds. */
+constexpr bool contains_seconds(const PackedDateTimeRange& range,
+                                std::uint32_t seconds) noexcept
+{
+    return (seconds >= range.start_seconds())
+           & (seconds - range.start_seconds() < range.length_seconds());
+}
+
+/* Calls fn(i, contains(ranges[i], dt)) for every range. */
+template <typename Fn>
+void for_each_contains(span<const PackedDateTimeRange> ranges,
+                       const DateTime& dt,
+                       Fn fn) noexcept
+{
+    const std::int64_t seconds = utils::epoch_seconds(dt);
+    if (seconds < 0
+        || seconds > std::numeric_limits<std::uint32_t>::max()) {
+        // Only ranges that end after 2106 may contain such instants
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+            fn(i, contains(ranges[i], dt));
+        return;
+    }
+    const auto narrow = static_cast<std::uint32_t>(seconds);
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+        fn(i, contains_seconds(ranges[i], narrow));
+}
+
+} // namespace detail
+
+inline void contains(span<const PackedDateTimeRange> ranges,
+                     const DateTime& dt,
+                     span<std::uint8_t> flags)
+{
+    if (ranges.size() != flags.size())
+        throw std::invalid_argument("ranges and flags sizes differ");
+    std::uint8_t* const out = flags.data();
+    detail::for_each_contains(ranges, dt, [out](std::size_t i, bool flag) {
+        out[i] = static_cast<std::uint8_t>(flag);
+    });
+}
+
+inline void overlaps(span<const PackedDateTimeRange> ranges,
+                     const PackedDateTimeRange& probe,
+                     span<std::uint8_t> flags)
+{
+    if (ranges.size() != flags.size())
+        throw std::invalid_argument("ranges and flags sizes differ");
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+        flags[i] = static_cast<std::uint8_t>(overlaps(ranges[i], probe));
+}
+
+inline std::size_t count_containing(span<const PackedDateTimeRange> ranges,
+                                    const DateTime& dt) noexcept
+{
+    std::size_t count = 0;
+    detail::for_each_contains(ranges, dt, [&count](std::size_t, bool flag) {
+        count += static_cast<std::size_t>(flag);
+    });
+    return count;
+}
+
+inline std::size_t
+count_overlapping(span<const PackedDateTimeRange> ranges,
+                  const PackedDateTimeRange& probe) noexcept
+{
+    std::size_t count = 0;
+    for (const auto& range : ranges)
+        count += static_cast<std::size_t>(overlaps(range, probe));
+    return count;
+}
+
+namespace utils {
+
+inline constexpr std::int64_t epoch_seconds(const DateTime& dt) noexcept
+{
+    return to_time_point<std::chrono::seconds>(dt).time_since_epoch().count();
+}
+
+inline constexpr std::chrono::time_point<std::chrono::system_clock,
+                                         std::chrono::seconds>
+from_epoch_seconds(std::int64_t seconds) noexcept
+{
+    return std::chrono::time_point<std::chrono::system_clock,
+                                   std::chrono::seconds>{
+        std::chrono::seconds{seconds}};
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: PACKED_RANGE_H_D3RV6KWA */
@@ -0,0 +1,586 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef PARALLEL_H_7KX3MWQE
+#define PARALLEL_H_7KX3MWQE
+
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace dw {
+
+/* Splits range into at most n contiguous subranges of nearly equal length.
+ * Both endpoints of DateRange are inclusive, so subranges don't overlap and
+ * there are no more of them than days in the range.
+ * Throws std::invalid_argument if n is 0. */
+std::vector<DateRange> split(const DateRange& range, std::size_t n);
+
+/* Splits range into n contiguous subranges of nearly equal duration.
+ * Finish of each subrange is the start of the next one.
+ * Throws std::invalid_argument if n is 0. */
+std::vector<DateTimeRange> split(const DateTimeRange& range, std::size_t n);
+
+/* Splits range at calendar day, ISO week or month boundaries. First and last
+ * subranges are clipped to the range. */
+std::vector<DateRange> split_by(const DateRange& range, BucketUnit unit);
+
+/* Splits range at midnights that start calendar days, ISO weeks or months.
+ * Finish of each subrange is the start of the next one. */
+std::vector<DateTimeRange> split_by(const DateTimeRange& range,
+                                    BucketUnit unit);
+
+/* Calls fn(date) for range.start(), range.start() + step, ... up to and
+ * including range.finish().
+ *
+ * Calls are distributed over a pool of concurrency threads that lives for
+ * the duration of the call; concurrency of 0 means
+ * std::thread::hardware_concurrency(). Each worker starts with a contiguous
+ * share of dates, and idle workers steal the upper half of the largest
+ * remaining share, so uneven per-date work is balanced. The first exception
+ * thrown by fn stops the remaining calls and is rethrown.
+ * Throws std::invalid_argument if step is not positive. */
+template <typename Fn>
+void parallel_for_each(const DateRange& range,
+                       Days step,
+                       Fn fn,
+                       unsigned concurrency = 0);
+
+/* Same as above, but calls fn(date_time) for each step in DateTimeRange. */
+template <typename Rep, typename Period, typename Fn>
+void parallel_for_each(const DateTimeRange& range,
+                       std::chrono::duration<Rep, Period> step,
+                       Fn fn,
+                       unsigned concurrency = 0);
+
+/* Returns number of values in the series range.start(), range.start() + step,
+ * ... up to and including range.finish(), as visited by parallel_for_each.
+ * Throws std::invalid_argument if step is not positive. */
+std::size_t series_size(const DateRange& range, Days step);
+
+template <typename Rep, typename Period>
+std::size_t series_size(const DateTimeRange& range,
+                        std::chrono::duration<Rep, Period> step);
+
+/* Same as above for calendar steps, where value i is range.start() + i * step
+ * months with day of month clamped as in operator+(const Date&, const
+ * Months&). */
+std::size_t series_size(const DateRange& range, Months step);
+
+std::size_t series_size(const DateTimeRange& range, Months step);
+
+/* Stores value i of the series into out[i] for every i below both out.size()
+ * and series_size(range, step). Returns number of stored values.
+ *
+ * Value i is computed directly from range.start() and i, not from value
+ * i - 1, so the loop has no carried dependency: out is split into contiguous
+ * chunks that are filled on concurrency threads, and concurrency of 0 means
+ * std::thread::hardware_concurrency(). Small outputs are filled on the
+ * calling thread.
+ * Throws std::invalid_argument if step is not positive. */
+std::size_t generate(const DateRange& range,
+                     Days step,
+                     span<Date> out,
+                     unsigned concurrency = 0);
+
+template <typename Rep, typename Period>
+std::size_t generate(const DateTimeRange& range,
+                     std::chrono::duration<Rep, Period> step,
+                     span<DateTime> out,
+                     unsigned concurrency = 0);
+
+/* Calendar step variants. Value i is start + i * step months, so a start on
+ * the 31st gives the last day of shorter months and returns to the 31st
+ * afterwards, unlike repeated addition of step. */
+std::size_t generate(const DateRange& range,
+                     Months step,
+                     span<Date> out,
+                     unsigned concurrency = 0);
+
+std::size_t generate(const DateTimeRange& range,
+                     Months step,
+                     span<DateTime> out,
+                     unsigned concurrency = 0);
+
+namespace utils {
+
+/* Returns first date of the calendar unit that follows the one containing
+ * date. */
+constexpr Date next_unit_start(const Date& date, BucketUnit unit) noexcept;
+
+/* Calls fn(index) for every index in [0, size) on a work-stealing pool of
+ * concurrency threads. First exception from fn or from starting a thread
+ * stops remaining work and is rethrown after started threads are joined. */
+template <typename Fn>
+void for_each_index_stealing(std::size_t size, unsigned concurrency, Fn& fn);
+
+/* Splits [0, size) into at most concurrency contiguous chunks of at least
+ * min_chunk_size elements and calls fn(chunk_index, first, last) for each of
+ * them on a separate thread. Returns number of chunks. First exception from
+ * fn or from starting a thread is rethrown after all started threads are
+ * joined. */
+template <typename Fn>
+std::size_t for_each_chunk(std::size_t size,
+                           unsigned concurrency,
+                           Fn fn,
+                           std::size_t min_chunk_size = 4096);
+
+} // namespace utils
+
+// Range splitting implementation
+
+inline std::vector<DateRange> split(const DateRange& range, std::size_t n)
+{
+    if (n == 0)
+        throw std::invalid_argument("split count must be positive");
+    const Date start{std::min(range.start(), range.finish())};
+    const auto days = static_cast<std::size_t>(range.duration().count()) + 1;
+    n = std::min(n, days);
+    std::vector<DateRange> result;
+    result.reserve(n);
+    const std::size_t quotient = days / n;
+    const std::size_t remainder = days % n;
+    long long first = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto length = static_cast<long long>(quotient + (i < remainder));
+        result.emplace_back(start + Days{first},
+                            start + Days{first + length - 1});
+        first += length;
+    }
+    return result;
+}
+
+inline std::vector<DateTimeRange> split(const DateTimeRange& range,
+                                        std::size_t n)
+{
+    using Duration = std::chrono::system_clock::duration;
+    if (n == 0)
+        throw std::invalid_argument("split count must be positive");
+    const DateTime start{std::min(range.start(), range.finish())};
+    const Duration total{range.duration<Duration>()};
+    const auto parts = static_cast<Duration::rep>(n);
+    const Duration quotient{total / parts};
+    const Duration remainder{total % parts};
+    std::vector<DateTimeRange> result;
+    result.reserve(n);
+    DateTime first{start};
+    for (Duration::rep i = 1; i <= parts; ++i) {
+        const DateTime last{start + quotient * i + remainder * i / parts};
+        result.emplace_back(first, last);
+        first = last;
+    }
+    return result;
+}
+
+inline std::vector<DateRange> split_by(const DateRange& range,
+                                       BucketUnit unit)
+{
+    const Date start{std::min(range.start(), range.finish())};
+    const Date finish{std::max(range.start(), range.finish())};
+    std::vector<DateRange> result;
+    for (Date first{start}; first <= finish;) {
+        const Date next{utils::next_unit_start(first, unit)};
+        result.emplace_back(first, std::min(finish, next - Days{1}));
+        first = next;
+    }
+    return result;
+}
+
+inline std::vector<DateTimeRange> split_by(const DateTimeRange& range,
+                                           BucketUnit unit)
+{
+    const DateTime start{std::min(range.start(), range.finish())};
+    const DateTime finish{std::max(range.start(), range.finish())};
+    std::vector<DateTimeRange> result;
+    DateTime first{start};
+    while (first < finish) {
+        const DateTime next{utils::next_unit_start(first.date(), unit)};
+        result.emplace_back(first, std::min(finish, next));
+        first = next;
+    }
+    if (result.empty())
+        result.emplace_back(start, finish);
+    return result;
+}
+
+// Parallel iteration implementation
+
+template <typename Fn>
+void parallel_for_each(const DateRange& range,
+                       Days step,
+                       Fn fn,
+                       unsigned concurrency)
+{
+    if (step <= Days{0})
+        throw std::invalid_argument("step must be positive");
+    const Date start{std::min(range.start(), range.finish())};
+    const auto count = static_cast<std::size_t>(range.duration() / step) + 1;
+    auto call = [&](std::size_t index) {
+        fn(start + step * static_cast<long long>(index));
+    };
+    utils::for_each_index_stealing(count, concurrency, call);
+}
+
+template <typename Rep, typename Period, typename Fn>
+void parallel_for_each(const DateTimeRange& range,
+                       std::chrono::duration<Rep, Period> step,
+                       Fn fn,
+                       unsigned concurrency)
+{
+    using Duration = std::chrono::system_clock::duration;
+    const auto fine_step = std::chrono::duration_cast<Duration>(step);
+    if (fine_step <= Duration::zero())
+        throw std::invalid_argument("step must be positive");
+    const DateTime start{std::min(range.start(), range.finish())};
+    const auto count =
+        static_cast<std::size_t>(range.duration<Duration>() / fine_step) + 1;
+    auto call = [&](std::size_t index) {
+        fn(start + fine_step * static_cast<Duration::rep>(index));
+    };
+    utils::for_each_index_stealing(count, concurrency, call);
+}
+
+// Series generation implementation
+
+namespace detail {
+
+inline unsigned resolve_concurrency(unsigned concurrency) noexcept
+{
+    return concurrency == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                            : concurrency;
+}
+
+/* Stores value(i) into out[i] for i in [0, size) in contiguous chunks. */
+template <typename T, typename Value>
+std::size_t generate_indexed(std::size_t size,
+                             span<T> out,
+                             unsigned concurrency,
+                             Value value)
+{
+    size = std::min(size, out.size());
+    T* const data = out.data();
+    utils::for_each_chunk(
+        size,
+        resolve_concurrency(concurrency),
+        [data, &value](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i)
+                data[i] = value(i);
+        });
+    return size;
+}
+
+/* Returns number of values start + i * step months that are not after
+ * finish. */
+template <typename T>
+std::size_t month_series_size(const T& start,
+                              const T& finish,
+                              const Date& start_date,
+                              const Date& finish_date,
+                              Months step)
+{
+    if (step <= Months{0})
+        throw std::invalid_argument("step must be positive");
+    long long count = (utils::month_index(finish_date)
+                       - utils::month_index(start_date))
+                      / step.count();
+    // Clamping or time of day can move the last candidate past finish
+    if (start + Months{count * step.count()} > finish)
+        --count;
+    return static_cast<std::size_t>(count) + 1;
+}
+
+} // namespace detail
+
+inline std::size_t series_size(const DateRange& range, Days step)
+{
+    if (step <= Days{0})
+        throw std::invalid_argument("step must be positive");
+    return static_cast<std::size_t>(range.duration() / step) + 1;
+}
+
+template <typename Rep, typename Period>
+std::size_t series_size(const DateTimeRange& range,
+                        std::chrono::duration<Rep, Period> step)
+{
+    using Duration = std::chrono::system_clock::duration;
+    const auto fine_step = std::chrono::duration_cast<Duration>(step);
+    if (fine_step <= Duration::zero())
+        throw std::invalid_argument("step must be positive");
+    return static_cast<std::size_t>(range.duration<Duration>() / fine_step)
+           + 1;
+}
+
+inline std::size_t series_size(const DateRange& range, Months step)
+{
+    const Date start{std::min(range.start(), range.finish())};
+    const Date finish{std::max(range.start(), range.finish())};
+    return detail::month_series_size(start, finish, start, finish, step);
+}
+
+inline std::size_t series_size(const DateTimeRange& range, Months step)
+{
+    const DateTime start{std::min(range.start(), range.finish())};
+    const DateTime finish{std::max(range.start(), range.finish())};
+    return detail::month_series_size(
+        start, finish, start.date(), finish.date(), step);
+}
+
+inline std::size_t generate(const DateRange& range,
+                            Days step,
+                            span<Date> out,
+                            unsigned concurrency)
+{
+    const Date start{std::min(range.start(), range.finish())};
+    const long long days = step.count();
+    return detail::generate_indexed(
+        series_size(range, step), out, concurrency, [=](std::size_t i) {
+            return start + Days{days * static_cast<long long>(i)};
+        });
+}
+
+template <typename Rep, typename Period>
+std::size_t generate(const DateTimeRange& range,
+                     std::chrono::duration<Rep, Period> step,
+                     span<DateTime> out,
+                     unsigned concurrency)
+{
+    using Duration = std::chrono::system_clock::duration;
+    const std::size_t size = series_size(range, step);
+    const auto start = to_time_point<Duration>(
+        std::min(range.start(), range.finish()));
+    const auto fine_step = std::chrono::duration_cast<Duration>(step);
+    return detail::generate_indexed(
+        size, out, concurrency, [=](std::size_t i) {
+            return DateTime{start
+                            + fine_step * static_cast<Duration::rep>(i)};
+        });
+}
+
+inline std::size_t generate(const DateRange& range,
+                            Months step,
+                            span<Date> out,
+                            unsigned concurrency)
+{
+    const Date start{std::min(range.start(), range.finish())};
+    const long long months = step.count();
+    return detail::generate_indexed(
+        series_size(range, step), out, concurrency, [=](std::size_t i) {
+            return start + Months{months * static_cast<long long>(i)};
+        });
+}
+
+inline std::size_t generate(const DateTimeRange& range,
+                            Months step,
+                            span<DateTime> out,
+                            unsigned concurrency)
+{
+    const DateTime start{std::min(range.start(), range.finish())};
+    const long long months = step.count();
+    return detail::generate_indexed(
+        series_size(range, step), out, concurrency, [=](std::size_t i) {
+            return start + Months{months * static_cast<long long>(i)};
+        });
+}
+
+namespace detail {
+
+/* Share of indices [first, last) owned by one worker. Padded to a cache line
+ * so that workers don't contend on neighbouring shares. */
+struct alignas(64) WorkShare {
+    std::mutex mutex;
+    std::size_t first{0};
+    std::size_t last{0};
+};
+
+inline bool pop_front(WorkShare& share, std::size_t& index)
+{
+    const std::lock_guard<std::mutex> lock{share.mutex};
+    if (share.first == share.last)
+        return false;
+    index = share.first++;
+    return true;
+}
+
+/* Moves upper half of the largest share of other workers to the thief's
+ * share and takes its first index. */
+inline bool
+steal(std::vector<WorkShare>& shares, std::size_t thief, std::size_t& index)
+{
+    for (;;) {
+        std::size_t victim = shares.size();
+        std::size_t largest = 0;
+        for (std::size_t i = 0; i < shares.size(); ++i) {
+            if (i == thief)
+                continue;
+            const std::lock_guard<std::mutex> lock{shares[i].mutex};
+            if (shares[i].last - shares[i].first > largest) {
+                largest = shares[i].last - shares[i].first;
+                victim = i;
+            }
+        }
+        if (victim == shares.size())
+            return false;
+        std::size_t first;
+        std::size_t last;
+        {
+            const std::lock_guard<std::mutex> lock{shares[victim].mutex};
+            const std::size_t left =
+                shares[victim].last - shares[victim].first;
+            if (left == 0)
+                continue;
+            first = shares[victim].first + left / 2;
+            last = shares[victim].last;
+            shares[victim].last = first;
+        }
+        const std::lock_guard<std::mutex> lock{shares[thief].mutex};
+        shares[thief].first = first + 1;
+        shares[thief].last = last;
+        index = first;
+        return true;
+    }
+}
+
+} // namespace detail
+
+namespace utils {
+
+constexpr Date next_unit_start(const Date& date, BucketUnit unit) noexcept
+{
+    switch (unit) {
+    case BucketUnit::Day:
+        return date + Days{1};
+    case BucketUnit::IsoWeek:
+        return next_weekday_excluding_current(date, Weekday::Monday);
+    case BucketUnit::Month:
+        return last_day_of_month(date) + Days{1};
+    }
+    return date + Days{1};
+}
+
+template <typename Fn>
+void for_each_index_stealing(std::size_t size, unsigned concurrency, Fn& fn)
+{
+    const std::size_t workers = std::min<std::size_t>(
+        size,
+        concurrency == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                         : concurrency);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < size; ++i)
+            fn(i);
+        return;
+    }
+    std::vector<detail::WorkShare> shares(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        shares[i].first = size * i / workers;
+        shares[i].last = size * (i + 1) / workers;
+    }
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&](std::size_t self) {
+        try {
+            std::size_t index;
+            while (!failed.load(std::memory_order_relaxed)
+                   && (detail::pop_front(shares[self], index)
+                       || detail::steal(shares, self, index)))
+                fn(index);
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock{error_mutex};
+            if (!error)
+                error = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+    std::vector<std::thread> threads;
+    try {
+        threads.reserve(workers - 1);
+        for (std::size_t i = 1; i < workers; ++i)
+            threads.emplace_back(work, i);
+    } catch (...) {
+        // Thread could not be started, stop the ones that did
+        const std::lock_guard<std::mutex> lock{error_mutex};
+        if (!error)
+            error = std::current_exception();
+        failed.store(true, std::memory_order_relaxed);
+    }
+    work(0);
+    for (auto& thread : threads)
+        thread.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+template <typename Fn>
+std::size_t for_each_chunk(std::size_t size,
+                           unsigned concurrency,
+                           Fn fn,
+                           std::size_t min_chunk_size)
+{
+    const std::size_t chunks = std::max<std::size_t>(
+        1, std::min<std::size_t>(concurrency, size / min_chunk_size));
+    if (chunks == 1) {
+        fn(std::size_t{0}, std::size_t{0}, size);
+        return 1;
+    }
+    const std::size_t chunk_size = (size + chunks - 1) / chunks;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto keep_error = [&] {
+        const std::lock_guard<std::mutex> lock{error_mutex};
+        if (!error)
+            error = std::current_exception();
+    };
+    auto work = [&](std::size_t chunk) {
+        const std::size_t first = chunk * chunk_size;
+        try {
+            fn(chunk, first, std::min(size, first + chunk_size));
+        } catch (...) {
+            keep_error();
+        }
+    };
+    std::vector<std::thread> workers;
+    try {
+        workers.reserve(chunks - 1);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+            workers.emplace_back(work, chunk);
+        work(0);
+    } catch (...) {
+        // Thread could not be started, chunks that were not run are lost
+        keep_error();
+    }
+    for (auto& worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+    return chunks;
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: PARALLEL_H_7KX3MWQE */
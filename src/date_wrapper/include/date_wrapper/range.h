@@ -0,0 +1,523 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef RANGE_H_J3WX8N5T
+#define RANGE_H_J3WX8N5T
+
+#include "core.h"
+#include "span.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+
+namespace dw {
+
+/* Represent finite interval of dates. */
+class DateRange {
+public:
+    constexpr DateRange(Date start, Date finish) noexcept;
+
+    constexpr Date start() const noexcept;
+
+    constexpr Date finish() const noexcept;
+
+    /* Returns duration in Days (that is std::chrono::duration type). */
+    constexpr Days duration() const noexcept;
+
+private:
+    Date start_;
+    Date finish_;
+};
+
+constexpr bool operator==(const DateRange& lhs, const DateRange& rhs);
+
+constexpr bool operator!=(const DateRange& lhs, const DateRange& rhs);
+
+/* Returns new DateRange with start and finish adjusted by offset. */
+constexpr DateRange add_offset(const DateRange& date_range,
+                               const Days& offset) noexcept;
+
+/* Calendar unit that determines boundaries of CalendarHistogram buckets and
+ * of range splits. */
+enum class BucketUnit { Day, IsoWeek, Month };
+
+/* Returns number of ISO weeks in ISO week-numbering year, 52 or 53. */
+constexpr unsigned iso_weeks_in_year(Year year) noexcept;
+
+/* Returns DateRange from Monday to Sunday of ISO week. */
+constexpr DateRange iso_week_range(Year year, unsigned weeknum) noexcept;
+
+/* Returns DateRange of ISO week that contains iso_date. */
+constexpr DateRange iso_week_range(const IsoDate& iso_date) noexcept;
+
+/* Returns DateRange from Monday of the first ISO week to Sunday of the last
+ * ISO week of ISO week-numbering year. */
+constexpr DateRange iso_year_range(Year year) noexcept;
+
+/* Forward iterator over consecutive ISO weeks. Dereferences to IsoDate of
+ * the Monday of current week. */
+class IsoWeekIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = IsoDate;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const IsoDate*;
+    using reference = const IsoDate&;
+
+    constexpr IsoWeekIterator() noexcept = default;
+
+    constexpr explicit IsoWeekIterator(const IsoDate& monday) noexcept;
+
+    constexpr reference operator*() const noexcept;
+
+    constexpr pointer operator->() const noexcept;
+
+    constexpr IsoWeekIterator& operator++() noexcept;
+
+    constexpr IsoWeekIterator operator++(int) noexcept;
+
+private:
+    IsoDate monday_;
+};
+
+constexpr bool operator==(const IsoWeekIterator& lhs,
+                          const IsoWeekIterator& rhs) noexcept;
+
+constexpr bool operator!=(const IsoWeekIterator& lhs,
+                          const IsoWeekIterator& rhs) noexcept;
+
+/* Lazy sequence of ISO weeks that intersect a DateRange. Weeks are computed
+ * by stepping packed IsoDate, without visiting individual days. */
+class IsoWeekRange {
+public:
+    constexpr explicit IsoWeekRange(const DateRange& range) noexcept;
+
+    constexpr IsoWeekIterator begin() const noexcept;
+
+    constexpr IsoWeekIterator end() const noexcept;
+
+    /* Returns number of weeks. */
+    constexpr std::size_t size() const noexcept;
+
+private:
+    IsoDate first_;
+    IsoDate last_;
+    std::size_t size_;
+};
+
+/* Returns ISO weeks that intersect the range. */
+constexpr IsoWeekRange iso_weeks(const DateRange& range) noexcept;
+
+/* Set of weekdays: bit N is set when Weekday with value N is in the set. */
+using WeekdayMask = std::uint8_t;
+
+constexpr WeekdayMask weekday_mask(Weekday weekday) noexcept;
+
+constexpr WeekdayMask weekend_mask{0x60};
+
+constexpr WeekdayMask working_days_mask{0x1f};
+
+/* Returns number of days with target Weekday in the range, both endpoints
+ * included. Computed from duration() and weekday of the start in O(1). */
+constexpr long long count_weekday(const DateRange& range,
+                                  Weekday target) noexcept;
+
+/* Returns number of days in the range whose Weekday is in the mask. */
+constexpr long long count_weekdays(const DateRange& range,
+                                   WeekdayMask mask) noexcept;
+
+/* Stores count_weekday(ranges[i], target) into counts[i].
+ * Throws std::invalid_argument if sizes differ. */
+void count_weekday(span<const DateRange> ranges,
+                   Weekday target,
+                   span<long long> counts);
+
+/* Stores count_weekdays(ranges[i], mask) into counts[i].
+ * Throws std::invalid_argument if sizes differ. */
+void count_weekdays(span<const DateRange> ranges,
+                    WeekdayMask mask,
+                    span<long long> counts);
+
+/* Represent finite interval in time with start and finish points. */
+struct DateTimeRange {
+
+    template <typename Clock, typename Duration>
+    constexpr DateTimeRange(
+        const std::chrono::time_point<Clock, Duration>& start,
+        const std::chrono::time_point<Clock, Duration>& finish) noexcept;
+
+    constexpr DateTimeRange(const DateTime& start,
+                            const DateTime& finish) noexcept;
+
+    constexpr DateTime start() const noexcept;
+
+    constexpr DateTime finish() const noexcept;
+
+    /* Return size of TimeInterval with specified duration.
+     * Duration is restricted to std::chrono::duration type.
+     * Note, that when dealing with very fine resolution or very large date
+     * range, special care needs to be taken, as these cases are subject
+     * to potential overflow error; in other words, user must be sure that
+     * requested duration is able to hold the desired value.
+     */
+    template <typename ToDuration>
+    constexpr ToDuration duration() const noexcept;
+
+private:
+    DateTime start_;
+    DateTime finish_;
+};
+
+constexpr bool operator!=(const DateTimeRange& lhs,
+                          const DateTimeRange& rhs) noexcept;
+
+constexpr bool operator==(const DateTimeRange& lhs,
+                          const DateTimeRange& rhs) noexcept;
+
+/* Returns new DateTimeRange with start and finish adjusted by offset. */
+constexpr DateTimeRange add_offset(const DateTimeRange& dt_range,
+                                   std::chrono::seconds offset) noexcept;
+
+/* Interval operations below treat DateTimeRange as half-open interval
+ * [start, finish) of its canonical form, so reversed ranges behave as their
+ * swapped counterparts. Range with start equal to finish is empty: it
+ * contains nothing and overlaps nothing. */
+
+/* Returns range with start not later than finish. */
+constexpr DateTimeRange canonical(const DateTimeRange& range) noexcept;
+
+constexpr bool empty(const DateTimeRange& range) noexcept;
+
+constexpr bool contains(const DateTimeRange& range,
+                        const DateTime& dt) noexcept;
+
+/* Returns true when every instant of inner is in range. Empty inner is
+ * contained in any range. */
+constexpr bool contains(const DateTimeRange& range,
+                        const DateTimeRange& inner) noexcept;
+
+/* Returns true when ranges share at least one instant. */
+constexpr bool overlaps(const DateTimeRange& lhs,
+                        const DateTimeRange& rhs) noexcept;
+
+/* Returns shared part of ranges, or nullopt if they don't overlap. */
+constexpr std::optional<DateTimeRange>
+intersection(const DateTimeRange& lhs, const DateTimeRange& rhs) noexcept;
+
+// DateRange implementation
+
+constexpr DateRange::DateRange(Date start, Date finish) noexcept
+    : start_{std::move(start)}
+    , finish_{std::move(finish)}
+{
+}
+
+constexpr Date DateRange::start() const noexcept { return start_; }
+
+constexpr Date DateRange::finish() const noexcept { return finish_; }
+
+constexpr Days DateRange::duration() const noexcept
+{
+    const date::sys_days ds_start{utils::to_ymd(start_)};
+    const date::sys_days ds_finish{utils::to_ymd(finish_)};
+    return date::abs(ds_finish - ds_start);
+}
+
+inline constexpr bool operator==(const DateRange& lhs, const DateRange& rhs)
+{
+    return lhs.start() == rhs.start() && lhs.finish() == rhs.finish();
+}
+
+inline constexpr bool operator!=(const DateRange& lhs, const DateRange& rhs)
+{
+    return !(lhs == rhs);
+}
+
+constexpr DateRange add_offset(const DateRange& date_range,
+                               const Days& offset) noexcept
+{
+    return DateRange{date_range.start() + offset, date_range.finish() + offset};
+}
+
+// ISO week ranges implementation
+
+constexpr unsigned iso_weeks_in_year(Year year) noexcept
+{
+    // December 28th is always in the last week
+    return IsoDate{Date{year, Month{12}, Day{28}}}.weeknum();
+}
+
+constexpr DateRange iso_week_range(Year year, unsigned weeknum) noexcept
+{
+    return iso_week_range(IsoDate{year, weeknum, Weekday::Monday});
+}
+
+constexpr DateRange iso_week_range(const IsoDate& iso_date) noexcept
+{
+    const Date monday{
+        IsoDate{iso_date.year(), iso_date.weeknum(), Weekday::Monday}.date()};
+    return DateRange{monday, monday + Days{6}};
+}
+
+constexpr DateRange iso_year_range(Year year) noexcept
+{
+    const Date monday{IsoDate{year, 1, Weekday::Monday}.date()};
+    return DateRange{monday,
+                     monday + Weeks{static_cast<Weeks::rep>(
+                                  iso_weeks_in_year(year))}
+                         - Days{1}};
+}
+
+constexpr IsoWeekIterator::IsoWeekIterator(const IsoDate& monday) noexcept
+    : monday_{monday}
+{
+}
+
+constexpr IsoWeekIterator::reference IsoWeekIterator::operator*() const
+    noexcept
+{
+    return monday_;
+}
+
+constexpr IsoWeekIterator::pointer IsoWeekIterator::operator->() const
+    noexcept
+{
+    return &monday_;
+}
+
+constexpr IsoWeekIterator& IsoWeekIterator::operator++() noexcept
+{
+    const unsigned weeknum = monday_.weeknum();
+    if (weeknum < 52 || weeknum < iso_weeks_in_year(monday_.year())) {
+        // Weeknum occupies bits above weekday, see IsoDate::packed()
+        monday_ = IsoDate::from_packed(monday_.packed() + 8);
+    } else {
+        monday_ = IsoDate{Year{static_cast<int>(monday_.year()) + 1},
+                          1,
+                          Weekday::Monday};
+    }
+    return *this;
+}
+
+constexpr IsoWeekIterator IsoWeekIterator::operator++(int) noexcept
+{
+    IsoWeekIterator previous{*this};
+    ++*this;
+    return previous;
+}
+
+inline constexpr bool operator==(const IsoWeekIterator& lhs,
+                                 const IsoWeekIterator& rhs) noexcept
+{
+    return *lhs == *rhs;
+}
+
+inline constexpr bool operator!=(const IsoWeekIterator& lhs,
+                                 const IsoWeekIterator& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+constexpr IsoWeekRange::IsoWeekRange(const DateRange& range) noexcept
+    : first_{prev_weekday(std::min(range.start(), range.finish()),
+                          Weekday::Monday)}
+    , last_{prev_weekday(std::max(range.start(), range.finish()),
+                         Weekday::Monday)
+            + Weeks{1}}
+    , size_{static_cast<std::size_t>((utils::serial_day(last_.date())
+                                      - utils::serial_day(first_.date()))
+                                     / 7)}
+{
+}
+
+constexpr IsoWeekIterator IsoWeekRange::begin() const noexcept
+{
+    return IsoWeekIterator{first_};
+}
+
+constexpr IsoWeekIterator IsoWeekRange::end() const noexcept
+{
+    return IsoWeekIterator{last_};
+}
+
+constexpr std::size_t IsoWeekRange::size() const noexcept { return size_; }
+
+constexpr IsoWeekRange iso_weeks(const DateRange& range) noexcept
+{
+    return IsoWeekRange{range};
+}
+
+// Weekday counting implementation
+
+constexpr WeekdayMask weekday_mask(Weekday weekday) noexcept
+{
+    return static_cast<WeekdayMask>(1u << static_cast<unsigned>(weekday));
+}
+
+constexpr long long count_weekday(const DateRange& range,
+                                  Weekday target) noexcept
+{
+    return count_weekdays(range, weekday_mask(target));
+}
+
+constexpr long long count_weekdays(const DateRange& range,
+                                   WeekdayMask mask) noexcept
+{
+    const long long days = range.duration().count() + 1;
+    const long long start = utils::serial_day(
+        std::min(range.start(), range.finish()));
+    // 1970-01-01 is Thursday, Monday is 0
+    const long long shifted = (start + 3) % 7;
+    const auto first = static_cast<unsigned>(shifted < 0 ? shifted + 7
+                                                         : shifted);
+    const auto rest = static_cast<unsigned>(days % 7);
+    // Days left after full weeks cover weekdays [first, first + rest)
+    const unsigned week = mask & 0x7fu;
+    const unsigned twice = week | week << 7;
+    const unsigned tail = (twice >> first) & ((1u << rest) - 1);
+    return days / 7 * utils::popcount(week) + utils::popcount(tail);
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE void count_weekday(span<const DateRange> ranges,
+                                  Weekday target,
+                                  span<long long> counts)
+{
+    count_weekdays(ranges, weekday_mask(target), counts);
+}
+
+DW_OUT_OF_LINE void count_weekdays(span<const DateRange> ranges,
+                                   WeekdayMask mask,
+                                   span<long long> counts)
+{
+    if (ranges.size() != counts.size())
+        throw std::invalid_argument("ranges and counts sizes differ");
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+        counts[i] = count_weekdays(ranges[i], mask);
+}
+
+#endif
+
+// DateTimeRange implementation
+
+template <typename Clock, typename Duration>
+inline constexpr DateTimeRange::DateTimeRange(
+    const std::chrono::time_point<Clock, Duration>& start,
+    const std::chrono::time_point<Clock, Duration>& finish) noexcept
+    : start_{DateTime{start}}
+    , finish_{DateTime{finish}}
+{
+}
+
+constexpr DateTimeRange::DateTimeRange(const DateTime& start,
+                                       const DateTime& finish) noexcept
+    : start_{start}
+    , finish_{finish}
+{
+}
+
+constexpr DateTime DateTimeRange::start() const noexcept { return start_; }
+
+constexpr DateTime DateTimeRange::finish() const noexcept { return finish_; }
+
+template <typename ToDuration>
+inline constexpr ToDuration DateTimeRange::duration() const noexcept
+{
+    using namespace std::chrono;
+    static_assert(utils::is_chrono_duration<ToDuration>::value,
+                  "duration must be a std::chrono::duration");
+    return date::abs(to_time_point<ToDuration>(finish_) -
+                     to_time_point<ToDuration>(start_));
+}
+
+inline constexpr bool operator!=(const DateTimeRange& lhs,
+                                 const DateTimeRange& rhs) noexcept
+{
+    return lhs.start() != rhs.start() || lhs.finish() != rhs.finish();
+}
+
+inline bool constexpr operator==(const DateTimeRange& lhs,
+                                 const DateTimeRange& rhs) noexcept
+{
+    return !(lhs != rhs);
+}
+
+inline constexpr DateTimeRange add_offset(const DateTimeRange& dt_range,
+                                          std::chrono::seconds offset) noexcept
+{
+    return DateTimeRange{dt_range.start() + offset, dt_range.finish() + offset};
+}
+
+// Interval operations implementation
+
+constexpr DateTimeRange canonical(const DateTimeRange& range) noexcept
+{
+    if (range.finish() < range.start())
+        return DateTimeRange{range.finish(), range.start()};
+    return range;
+}
+
+constexpr bool empty(const DateTimeRange& range) noexcept
+{
+    return range.start() == range.finish();
+}
+
+constexpr bool contains(const DateTimeRange& range,
+                        const DateTime& dt) noexcept
+{
+    const DateTimeRange c{canonical(range)};
+    return c.start() <= dt && dt < c.finish();
+}
+
+constexpr bool contains(const DateTimeRange& range,
+                        const DateTimeRange& inner) noexcept
+{
+    const DateTimeRange c{canonical(range)};
+    const DateTimeRange i{canonical(inner)};
+    return empty(i) || (c.start() <= i.start() && i.finish() <= c.finish());
+}
+
+constexpr bool overlaps(const DateTimeRange& lhs,
+                        const DateTimeRange& rhs) noexcept
+{
+    const DateTimeRange l{canonical(lhs)};
+    const DateTimeRange r{canonical(rhs)};
+    return !empty(l) && !empty(r) && l.start() < r.finish()
+           && r.start() < l.finish();
+}
+
+constexpr std::optional<DateTimeRange>
+intersection(const DateTimeRange& lhs, const DateTimeRange& rhs) noexcept
+{
+    if (!overlaps(lhs, rhs))
+        return std::nullopt;
+    const DateTimeRange l{canonical(lhs)};
+    const DateTimeRange r{canonical(rhs)};
+    return DateTimeRange{std::max(l.start(), r.start()),
+                         std::min(l.finish(), r.finish())};
+}
+
+} // namespace dw
+
+#endif /* end of include guard: RANGE_H_J3WX8N5T */
@@ -0,0 +1,426 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef RELATIVE_H_J5PD8QXN
+#define RELATIVE_H_J5PD8QXN
+
+#include "core.h"
+#include "span.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace dw {
+
+/* Calendar period used by start_of and end_of steps of RelativeDate. */
+enum class CalendarPeriod { IsoWeek, Month, Quarter, Year };
+
+/* Rule that computes a date relative to another date, e.g. "last Friday of
+ * the month" or "end of quarter minus 2 days".
+ *
+ * The rule is built once as a sequence of steps and then applied to single
+ * dates or spans of dates. Steps run on a day number and civil year, month
+ * and day fields that are converted into each other only when a step needs
+ * the other form, so no intermediate Date is created.
+ *
+ *     const auto third_monday
+ *         = RelativeDate{}.start_of(CalendarPeriod::Month)
+ *               .nth_weekday(3, Weekday::Monday);
+ *     const Date date = third_monday(Date{Year{2019}, Month{5}, Day{10}});
+ */
+class RelativeDate {
+public:
+    /* Adjacent day steps are merged into one. */
+    RelativeDate& plus(Days days);
+
+    RelativeDate& plus(Weeks weeks);
+
+    /* Day of month is clamped to the last day of resulting month, as in
+     * operator+(const Date&, const Months&). */
+    RelativeDate& plus(Months months);
+
+    RelativeDate& plus(Years years);
+
+    RelativeDate& start_of(CalendarPeriod period);
+
+    RelativeDate& end_of(CalendarPeriod period);
+
+    /* Moves to the next target weekday, even if current date already has
+     * it, see next_weekday_excluding_current. */
+    RelativeDate& next(Weekday target);
+
+    /* Moves to the next target weekday or stays on current date, see
+     * next_weekday. */
+    RelativeDate& next_or_same(Weekday target);
+
+    /* Moves to the previous target weekday, even if current date already has
+     * it. */
+    RelativeDate& prev(Weekday target);
+
+    /* Moves to the previous target weekday or stays on current date. */
+    RelativeDate& prev_or_same(Weekday target);
+
+    /* Moves to the n-th target weekday of current month. Negative n counts
+     * from the end of the month, so -1 is the last one. Throws
+     * std::invalid_argument if n is 0 or its magnitude exceeds 5; the fifth
+     * weekday spills into the next month when the month has only four. */
+    RelativeDate& nth_weekday(int n, Weekday target);
+
+    /* Returns number of steps in the rule. */
+    std::size_t size() const noexcept;
+
+    Date operator()(const Date& date) const noexcept;
+
+    /* Stores rule applied to dates[i] into results[i].
+     * Throws std::invalid_argument if sizes differ. */
+    void operator()(span<const Date> dates, span<Date> results) const;
+
+private:
+    enum class Op : std::uint8_t {
+        AddDays,
+        AddMonths,
+        StartOfWeek,
+        EndOfWeek,
+        StartOfMonth,
+        EndOfMonth,
+        StartOfQuarter,
+        EndOfQuarter,
+        StartOfYear,
+        EndOfYear,
+        NextWeekday,
+        NextOrSameWeekday,
+        PrevWeekday,
+        PrevOrSameWeekday,
+        NthWeekday,
+        NthLastWeekday,
+    };
+
+    struct Step {
+        Op op;
+        std::uint8_t weekday;
+        long long value;
+    };
+
+    std::vector<Step> steps_;
+
+    RelativeDate& push(Op op, long long value, Weekday target = {});
+};
+
+namespace utils {
+
+/* Returns number of days since 1970-01-01 for proleptic Gregorian date. */
+constexpr long long
+days_from_civil(long long year, unsigned month, unsigned day) noexcept;
+
+/* Inverse of days_from_civil. */
+constexpr void civil_from_days(long long serial_day,
+                               long long& year,
+                               unsigned& month,
+                               unsigned& day) noexcept;
+
+constexpr unsigned days_in_month(long long year, unsigned month) noexcept;
+
+} // namespace utils
+
+// RelativeDate implementation
+
+inline RelativeDate& RelativeDate::plus(Days days)
+{
+    if (!steps_.empty() && steps_.back().op == Op::AddDays) {
+        steps_.back().value += static_cast<long long>(days.count());
+        return *this;
+    }
+    return push(Op::AddDays, static_cast<long long>(days.count()));
+}
+
+inline RelativeDate& RelativeDate::plus(Weeks weeks)
+{
+    return plus(Days{weeks});
+}
+
+inline RelativeDate& RelativeDate::plus(Months months)
+{
+    return push(Op::AddMonths, static_cast<long long>(months.count()));
+}
+
+inline RelativeDate& RelativeDate::plus(Years years)
+{
+    // Clamping February 29th gives the same result either way
+    return push(Op::AddMonths, static_cast<long long>(years.count()) * 12);
+}
+
+inline RelativeDate& RelativeDate::start_of(CalendarPeriod period)
+{
+    switch (period) {
+    case CalendarPeriod::IsoWeek:
+        return push(Op::StartOfWeek, 0);
+    case CalendarPeriod::Month:
+        return push(Op::StartOfMonth, 0);
+    case CalendarPeriod::Quarter:
+        return push(Op::StartOfQuarter, 0);
+    case CalendarPeriod::Year:
+        break;
+    }
+    return push(Op::StartOfYear, 0);
+}
+
+inline RelativeDate& RelativeDate::end_of(CalendarPeriod period)
+{
+    switch (period) {
+    case CalendarPeriod::IsoWeek:
+        return push(Op::EndOfWeek, 0);
+    case CalendarPeriod::Month:
+        return push(Op::EndOfMonth, 0);
+    case CalendarPeriod::Quarter:
+        return push(Op::EndOfQuarter, 0);
+    case CalendarPeriod::Year:
+        break;
+    }
+    return push(Op::EndOfYear, 0);
+}
+
+inline RelativeDate& RelativeDate::next(Weekday target)
+{
+    return push(Op::NextWeekday, 0, target);
+}
+
+inline RelativeDate& RelativeDate::next_or_same(Weekday target)
+{
+    return push(Op::NextOrSameWeekday, 0, target);
+}
+
+inline RelativeDate& RelativeDate::prev(Weekday target)
+{
+    return push(Op::PrevWeekday, 0, target);
+}
+
+inline RelativeDate& RelativeDate::prev_or_same(Weekday target)
+{
+    return push(Op::PrevOrSameWeekday, 0, target);
+}
+
+inline RelativeDate& RelativeDate::nth_weekday(int n, Weekday target)
+{
+    if (n == 0 || n > 5 || n < -5)
+        throw std::invalid_argument("weekday index must be in [-5, 5]");
+    if (n > 0)
+        return push(Op::NthWeekday, n - 1, target);
+    return push(Op::NthLastWeekday, -n - 1, target);
+}
+
+inline std::size_t RelativeDate::size() const noexcept
+{
+    return steps_.size();
+}
+
+inline RelativeDate&
+RelativeDate::push(Op op, long long value, Weekday target)
+{
+    steps_.push_back(Step{op, static_cast<std::uint8_t>(target), value});
+    return *this;
+}
+
+inline Date RelativeDate::operator()(const Date& date) const noexcept
+{
+    long long serial = utils::serial_day(date);
+    long long year = static_cast<int>(date.year());
+    unsigned month = static_cast<unsigned>(date.month());
+    unsigned day = static_cast<unsigned>(date.day());
+    // Which representation is up to date
+    bool civil = true;
+    bool days = true;
+    const auto to_civil = [&] {
+        if (!civil)
+            utils::civil_from_days(serial, year, month, day);
+        civil = true;
+    };
+    const auto to_days = [&] {
+        if (!days)
+            serial = utils::days_from_civil(year, month, day);
+        days = true;
+    };
+    const auto set_civil = [&](long long y, unsigned m, unsigned d) {
+        year = y;
+        month = m;
+        day = d;
+        civil = true;
+        days = false;
+    };
+    const auto set_days = [&](long long s) {
+        serial = s;
+        days = true;
+        civil = false;
+    };
+    // 1970-01-01 is Thursday, Monday is 0
+    const auto weekday_of = [](long long s) {
+        const long long shifted = (s + 3) % 7;
+        return shifted < 0 ? shifted + 7 : shifted;
+    };
+    for (const Step& step : steps_) {
+        const auto target = static_cast<long long>(step.weekday);
+        switch (step.op) {
+        case Op::AddDays:
+            to_days();
+            set_days(serial + step.value);
+            break;
+        case Op::AddMonths: {
+            to_civil();
+            const long long index
+                = year * 12 + static_cast<long long>(month) - 1 + step.value;
+            const long long y = (index >= 0 ? index : index - 11) / 12;
+            const auto m = static_cast<unsigned>(index - y * 12 + 1);
+            set_civil(y, m, std::min(day, utils::days_in_month(y, m)));
+            break;
+        }
+        case Op::StartOfWeek:
+            to_days();
+            set_days(serial - weekday_of(serial));
+            break;
+        case Op::EndOfWeek:
+            to_days();
+            set_days(serial - weekday_of(serial) + 6);
+            break;
+        case Op::StartOfMonth:
+            to_civil();
+            set_civil(year, month, 1);
+            break;
+        case Op::EndOfMonth:
+            to_civil();
+            set_civil(year, month, utils::days_in_month(year, month));
+            break;
+        case Op::StartOfQuarter:
+            to_civil();
+            set_civil(year, month - (month - 1) % 3, 1);
+            break;
+        case Op::EndOfQuarter: {
+            to_civil();
+            const unsigned last = month - (month - 1) % 3 + 2;
+            set_civil(year, last, utils::days_in_month(year, last));
+            break;
+        }
+        case Op::StartOfYear:
+            to_civil();
+            set_civil(year, 1, 1);
+            break;
+        case Op::EndOfYear:
+            to_civil();
+            set_civil(year, 12, 31);
+            break;
+        case Op::NextWeekday:
+            to_days();
+            set_days(serial + 1 + (target - weekday_of(serial) + 6) % 7);
+            break;
+        case Op::NextOrSameWeekday:
+            to_days();
+            set_days(serial + (target - weekday_of(serial) + 7) % 7);
+            break;
+        case Op::PrevWeekday:
+            to_days();
+            set_days(serial - 1 - (weekday_of(serial) - target + 6) % 7);
+            break;
+        case Op::PrevOrSameWeekday:
+            to_days();
+            set_days(serial - (weekday_of(serial) - target + 7) % 7);
+            break;
+        case Op::NthWeekday: {
+            to_civil();
+            const long long first = utils::days_from_civil(year, month, 1);
+            set_days(first + (target - weekday_of(first) + 7) % 7
+                     + 7 * step.value);
+            break;
+        }
+        case Op::NthLastWeekday: {
+            to_civil();
+            const long long last = utils::days_from_civil(
+                year, month, utils::days_in_month(year, month));
+            set_days(last - (weekday_of(last) - target + 7) % 7
+                     - 7 * step.value);
+            break;
+        }
+        }
+    }
+    to_civil();
+    return Date{Year{static_cast<int>(year)}, Month{month}, Day{day}};
+}
+
+inline void RelativeDate::operator()(span<const Date> dates,
+                                     span<Date> results) const
+{
+    if (dates.size() != results.size())
+        throw std::invalid_argument("dates and results sizes differ");
+    for (std::size_t i = 0; i < dates.size(); ++i)
+        results[i] = (*this)(dates[i]);
+}
+
+namespace utils {
+
+// Algorithms from http://howardhinnant.github.io/date_algorithms.html
+
+inline constexpr long long
+days_from_civil(long long year, unsigned month, unsigned day) noexcept
+{
+    year -= month <= 2;
+    const long long era = (year >= 0 ? year : year - 399) / 400;
+    const auto year_of_era = static_cast<unsigned>(year - era * 400);
+    const unsigned day_of_year
+        = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4
+                                - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<long long>(day_of_era) - 719468;
+}
+
+inline constexpr void civil_from_days(long long serial_day,
+                                      long long& year,
+                                      unsigned& month,
+                                      unsigned& day) noexcept
+{
+    serial_day += 719468;
+    const long long era
+        = (serial_day >= 0 ? serial_day : serial_day - 146096) / 146097;
+    const auto day_of_era = static_cast<unsigned>(serial_day - era * 146097);
+    const unsigned year_of_era = (day_of_era - day_of_era / 1460
+                                  + day_of_era / 36524 - day_of_era / 146096)
+                                 / 365;
+    const unsigned day_of_year
+        = day_of_era
+          - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const unsigned shifted_month = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+    month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+    year = static_cast<long long>(year_of_era) + era * 400 + (month <= 2);
+}
+
+inline constexpr unsigned days_in_month(long long year,
+                                        unsigned month) noexcept
+{
+    if (month != 2)
+        return month == 4 || month == 6 || month == 9 || month == 11 ? 30
+                                                                     : 31;
+    const bool leap
+        = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    return leap ? 29 : 28;
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: RELATIVE_H_J5PD8QXN */
@@ -0,0 +1,311 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef RLE_H_T6NB2YXG
+#define RLE_H_T6NB2YXG
+
+#include "core.h"
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dw {
+
+/* Run of equal dates in RleDateColumn: rows [first, first + count) hold
+ * date. */
+struct DateRun {
+    Date date;
+    std::size_t first;
+    std::size_t count;
+};
+
+/* Half-open range of row positions [first, last). */
+struct RowRange {
+    std::size_t first;
+    std::size_t last;
+};
+
+constexpr bool operator==(const RowRange& lhs, const RowRange& rhs) noexcept;
+
+constexpr bool operator!=(const RowRange& lhs, const RowRange& rhs) noexcept;
+
+/* Column of dates stored as runs of equal adjacent values.
+ *
+ * Only run headers are stored, so a day-sorted column of millions of rows
+ * takes a few bytes per distinct day. Random access finds the run by binary
+ * search over run starts, and counting, filtering and per-date aggregation
+ * visit run headers without expanding rows. While all runs are in ascending
+ * date order, which is the case for day-sorted data, filtering by DateRange
+ * is a binary search as well.
+ */
+class RleDateColumn {
+public:
+    RleDateColumn() = default;
+
+    /* Encodes plain column. */
+    explicit RleDateColumn(span<const Date> dates);
+
+    /* Number of rows. */
+    std::size_t size() const noexcept;
+
+    bool empty() const noexcept;
+
+    std::size_t run_count() const noexcept;
+
+    /* Returns true if run dates are strictly ascending, that is rows are
+     * sorted by date. */
+    bool sorted() const noexcept;
+
+    span<const DateRun> runs() const noexcept;
+
+    /* Returns date of the row in O(log run_count()). Row must be less than
+     * size(). */
+    Date operator[](std::size_t row) const noexcept;
+
+    /* Throws std::out_of_range if row is not less than size(). */
+    Date at(std::size_t row) const;
+
+    /* Returns index of the run that holds the row, or run_count() if row is
+     * not less than size(). */
+    std::size_t run_index(std::size_t row) const noexcept;
+
+    void push_back(const Date& date);
+
+    /* Appends count rows holding date. */
+    void append(const Date& date, std::size_t count);
+
+    void clear() noexcept;
+
+    /* Expands the column into plain form.
+     * Throws std::invalid_argument if out size differs from size(). */
+    void decode(span<Date> out) const;
+
+    /* Returns number of rows whose date is in the range. Both range endpoints
+     * are inclusive. */
+    std::size_t count(const DateRange& range) const noexcept;
+
+    /* Returns ascending, non-adjacent row ranges that hold dates in the
+     * range. */
+    std::vector<RowRange> filter(const DateRange& range) const;
+
+    /* Calls fn(date, row_count) once for each run. */
+    template <typename Fn> void for_each_run(Fn fn) const;
+
+private:
+    std::vector<DateRun> runs_;
+    std::size_t size_{0};
+    bool sorted_{true};
+
+    /* Returns [first, last) indices of runs with dates in the range of sorted
+     * column. */
+    std::pair<std::size_t, std::size_t>
+    sorted_runs(const Date& start, const Date& finish) const noexcept;
+};
+
+// RowRange implementation
+
+inline constexpr bool operator==(const RowRange& lhs,
+                                 const RowRange& rhs) noexcept
+{
+    return lhs.first == rhs.first && lhs.last == rhs.last;
+}
+
+inline constexpr bool operator!=(const RowRange& lhs,
+                                 const RowRange& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// RleDateColumn implementation
+
+template <typename Fn> void RleDateColumn::for_each_run(Fn fn) const
+{
+    for (const DateRun& run : runs_)
+        fn(run.date, run.count);
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE RleDateColumn::RleDateColumn(span<const Date> dates)
+{
+    for (const Date& date : dates)
+        push_back(date);
+}
+
+DW_OUT_OF_LINE std::size_t RleDateColumn::size() const noexcept
+{
+    return size_;
+}
+
+DW_OUT_OF_LINE bool RleDateColumn::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+DW_OUT_OF_LINE std::size_t RleDateColumn::run_count() const noexcept
+{
+    return runs_.size();
+}
+
+DW_OUT_OF_LINE bool RleDateColumn::sorted() const noexcept
+{
+    return sorted_;
+}
+
+DW_OUT_OF_LINE span<const DateRun> RleDateColumn::runs() const noexcept
+{
+    return span<const DateRun>{runs_.data(), runs_.size()};
+}
+
+DW_OUT_OF_LINE std::size_t RleDateColumn::run_index(std::size_t row) const
+    noexcept
+{
+    if (row >= size_)
+        return runs_.size();
+    const auto it = std::upper_bound(
+        runs_.begin(),
+        runs_.end(),
+        row,
+        [](std::size_t value, const DateRun& run) {
+            return value < run.first;
+        });
+    return static_cast<std::size_t>(it - runs_.begin()) - 1;
+}
+
+DW_OUT_OF_LINE Date RleDateColumn::operator[](std::size_t row) const noexcept
+{
+    return runs_[run_index(row)].date;
+}
+
+DW_OUT_OF_LINE Date RleDateColumn::at(std::size_t row) const
+{
+    if (row >= size_)
+        throw std::out_of_range("RleDateColumn row is out of range");
+    return (*this)[row];
+}
+
+DW_OUT_OF_LINE void RleDateColumn::push_back(const Date& date)
+{
+    append(date, 1);
+}
+
+DW_OUT_OF_LINE void RleDateColumn::append(const Date& date, std::size_t count)
+{
+    if (count == 0)
+        return;
+    if (!runs_.empty() && runs_.back().date == date) {
+        runs_.back().count += count;
+    } else {
+        if (!runs_.empty() && date < runs_.back().date)
+            sorted_ = false;
+        runs_.push_back(DateRun{date, size_, count});
+    }
+    size_ += count;
+}
+
+DW_OUT_OF_LINE void RleDateColumn::clear() noexcept
+{
+    runs_.clear();
+    size_ = 0;
+    sorted_ = true;
+}
+
+DW_OUT_OF_LINE void RleDateColumn::decode(span<Date> out) const
+{
+    if (out.size() != size_)
+        throw std::invalid_argument("output size differs from column size");
+    for (const DateRun& run : runs_)
+        std::fill_n(out.data() + run.first, run.count, run.date);
+}
+
+DW_OUT_OF_LINE std::size_t RleDateColumn::count(const DateRange& range) const
+    noexcept
+{
+    const Date start{std::min(range.start(), range.finish())};
+    const Date finish{std::max(range.start(), range.finish())};
+    if (sorted_) {
+        const auto runs = sorted_runs(start, finish);
+        if (runs.first == runs.second)
+            return 0;
+        const DateRun& last = runs_[runs.second - 1];
+        return last.first + last.count - runs_[runs.first].first;
+    }
+    std::size_t result = 0;
+    for (const DateRun& run : runs_) {
+        if (start <= run.date && run.date <= finish)
+            result += run.count;
+    }
+    return result;
+}
+
+DW_OUT_OF_LINE std::vector<RowRange>
+RleDateColumn::filter(const DateRange& range) const
+{
+    const Date start{std::min(range.start(), range.finish())};
+    const Date finish{std::max(range.start(), range.finish())};
+    std::vector<RowRange> result;
+    if (sorted_) {
+        const auto runs = sorted_runs(start, finish);
+        if (runs.first != runs.second) {
+            const DateRun& last = runs_[runs.second - 1];
+            result.push_back(RowRange{runs_[runs.first].first,
+                                      last.first + last.count});
+        }
+        return result;
+    }
+    for (const DateRun& run : runs_) {
+        if (run.date < start || finish < run.date)
+            continue;
+        if (!result.empty() && result.back().last == run.first)
+            result.back().last += run.count;
+        else
+            result.push_back(RowRange{run.first, run.first + run.count});
+    }
+    return result;
+}
+
+DW_OUT_OF_LINE std::pair<std::size_t, std::size_t>
+RleDateColumn::sorted_runs(const Date& start, const Date& finish) const
+    noexcept
+{
+    const auto first = std::lower_bound(
+        runs_.begin(),
+        runs_.end(),
+        start,
+        [](const DateRun& run, const Date& value) { return run.date < value; });
+    const auto last = std::upper_bound(
+        first,
+        runs_.end(),
+        finish,
+        [](const Date& value, const DateRun& run) { return value < run.date; });
+    return {static_cast<std::size_t>(first - runs_.begin()),
+            static_cast<std::size_t>(last - runs_.begin())};
+}
+
+#endif
+
+} // namespace dw
+
+#endif /* end of include guard: RLE_H_T6NB2YXG */
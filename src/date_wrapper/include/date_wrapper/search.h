@@ -0,0 +1,228 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef SEARCH_H_M2WJ6TUB
+#define SEARCH_H_M2WJ6TUB
+
+#include "core.h"
+#include "span.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DW_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define DW_PREFETCH(address) static_cast<void>(address)
+#endif
+
+namespace dw {
+
+/* Read-only lower_bound index over sorted DateTimes.
+ *
+ * Instants are stored as 64-bit nanosecond keys in Eytzinger (BFS) order,
+ * so the first levels of the implicit search tree share cache lines and each
+ * step of a query is a single comparison folded into the next index, without
+ * a data-dependent branch. Descendants three levels below the current node
+ * are adjacent and fill one cache line, which is prefetched while the
+ * comparison is in flight. Keys are limited to instants
+ * representable by std::chrono::nanoseconds: indexed values must be in years
+ * 1678 - 2261, probes outside compare below or above every value.
+ */
+class DateTimeIndex {
+public:
+    /* Throws std::invalid_argument if values are not sorted and
+     * std::out_of_range if they are outside years 1678 - 2261. */
+    explicit DateTimeIndex(span<const DateTime> sorted);
+
+    std::size_t size() const noexcept;
+
+    /* Returns position of the first value in the sorted input that is not
+     * less than dt, or size() if there is none. */
+    std::size_t lower_bound(const DateTime& dt) const noexcept;
+
+    /* Stores lower_bound(probes[i]) into positions[i]. Probes are advanced
+     * through the tree in interleaved groups, so that memory loads of
+     * different probes overlap.
+     * Throws std::invalid_argument if sizes differ. */
+    void lower_bound(span<const DateTime> probes,
+                     span<std::size_t> positions) const;
+
+private:
+    static constexpr std::size_t batch_size{16};
+
+    // Both arrays are 1-based: node k has children 2k and 2k + 1
+    std::vector<std::int64_t> keys_;
+    std::vector<std::size_t> positions_;
+
+    std::size_t fill(std::size_t node,
+                     std::size_t next,
+                     span<const DateTime> sorted) noexcept;
+
+    std::size_t position(std::size_t node) const noexcept;
+};
+
+namespace utils {
+
+/* Returns true if dt is in years 1678 - 2261, where to_key() is exact. */
+constexpr bool has_exact_key(const DateTime& dt) noexcept;
+
+/* Returns nanoseconds since the Unix epoch. Instants before 1678 or after
+ * 2261 saturate to the smallest or the largest key. */
+constexpr std::int64_t to_key(const DateTime& dt) noexcept;
+
+/* Returns number of trailing one bits. */
+constexpr unsigned count_trailing_ones(std::size_t value) noexcept;
+
+} // namespace utils
+
+// DateTimeIndex implementation
+
+inline DateTimeIndex::DateTimeIndex(span<const DateTime> sorted)
+    : keys_(sorted.size() + 1)
+    , positions_(sorted.size() + 1)
+{
+    for (std::size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i] < sorted[i - 1])
+            throw std::invalid_argument("DateTimeIndex input is not sorted");
+    }
+    if (!sorted.empty()
+        && !(utils::has_exact_key(sorted[0])
+             && utils::has_exact_key(sorted[sorted.size() - 1])))
+        throw std::out_of_range("DateTimeIndex supports years 1678 - 2261");
+    fill(1, 0, sorted);
+}
+
+inline std::size_t DateTimeIndex::size() const noexcept
+{
+    return keys_.size() - 1;
+}
+
+inline std::size_t DateTimeIndex::fill(std::size_t node,
+                                       std::size_t next,
+                                       span<const DateTime> sorted) noexcept
+{
+    if (node > sorted.size())
+        return next;
+    next = fill(2 * node, next, sorted);
+    keys_[node] = utils::to_key(sorted[next]);
+    positions_[node] = next;
+    return fill(2 * node + 1, next + 1, sorted);
+}
+
+inline std::size_t DateTimeIndex::position(std::size_t node) const noexcept
+{
+    // Node went right after the answer every time it went down since then,
+    // so the answer is node with its trailing ones and one more bit dropped
+    node >>= utils::count_trailing_ones(node) + 1;
+    return node == 0 ? size() : positions_[node];
+}
+
+inline std::size_t DateTimeIndex::lower_bound(const DateTime& dt) const
+    noexcept
+{
+    const std::int64_t key = utils::to_key(dt);
+    const std::size_t n = size();
+    const std::int64_t* keys = keys_.data();
+    std::size_t node = 1;
+    while (node <= n) {
+        DW_PREFETCH(keys + (8 * node < keys_.size() ? 8 * node : 0));
+        node = 2 * node + static_cast<std::size_t>(keys[node] < key);
+    }
+    return position(node);
+}
+
+inline void DateTimeIndex::lower_bound(span<const DateTime> probes,
+                                       span<std::size_t> positions) const
+{
+    if (probes.size() != positions.size())
+        throw std::invalid_argument("probes and positions sizes differ");
+    const std::size_t n = size();
+    const std::int64_t* keys = keys_.data();
+    std::int64_t batch_keys[batch_size];
+    std::size_t nodes[batch_size];
+    for (std::size_t first = 0; first < probes.size(); first += batch_size) {
+        const std::size_t count = std::min(batch_size, probes.size() - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            batch_keys[i] = utils::to_key(probes[first + i]);
+            nodes[i] = 1;
+        }
+        // All probes descend the same number of levels, give or take one
+        for (bool active = n != 0; active;) {
+            active = false;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (nodes[i] > n)
+                    continue;
+                DW_PREFETCH(keys + (8 * nodes[i] < keys_.size() ? 8 * nodes[i]
+                                                                : 0));
+                nodes[i] = 2 * nodes[i]
+                           + static_cast<std::size_t>(keys[nodes[i]]
+                                                      < batch_keys[i]);
+                active = true;
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i)
+            positions[first + i] = position(nodes[i]);
+    }
+}
+
+namespace utils {
+
+inline constexpr bool has_exact_key(const DateTime& dt) noexcept
+{
+    return !(dt.day_point() < sys_days{Date{Year{1678}, Month{1}, Day{1}}})
+           && dt.day_point() < sys_days{Date{Year{2262}, Month{1}, Day{1}}};
+}
+
+inline constexpr std::int64_t to_key(const DateTime& dt) noexcept
+{
+    using limits = std::numeric_limits<std::int64_t>;
+    if (!has_exact_key(dt))
+        return dt.day_point().time_since_epoch().count() < 0 ? limits::min()
+                                                              : limits::max();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               to_time_point<std::chrono::system_clock::duration>(dt)
+                   .time_since_epoch())
+        .count();
+}
+
+inline constexpr unsigned count_trailing_ones(std::size_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(
+        __builtin_ctzll(~static_cast<unsigned long long>(value)));
+#else
+    unsigned count = 0;
+    while (value & 1u) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: SEARCH_H_M2WJ6TUB */
@@ -0,0 +1,165 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef SPAN_H_M3T7RQ0C
+#define SPAN_H_M3T7RQ0C
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace dw {
+
+/* Minimal non-owning view over a contiguous sequence.
+ *
+ * Mirrors the subset of C++20 std::span used by bulk operations of this
+ * library, so that these operations can be used with C++17 compilers. */
+template <typename T> class span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    constexpr span() noexcept = default;
+
+    constexpr span(T* data, size_type size) noexcept;
+
+    template <std::size_t N> constexpr span(T (&arr)[N]) noexcept;
+
+    template <typename Container,
+              typename Element = std::remove_pointer_t<
+                  decltype(std::declval<Container&>().data())>,
+              typename = std::enable_if_t<
+                  std::is_convertible_v<Element (*)[], T (*)[]>>>
+    constexpr span(Container& container) noexcept;
+
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible_v<U (*)[],
+                                                                T (*)[]>>>
+    constexpr span(const span<U>& other) noexcept;
+
+    constexpr T* data() const noexcept;
+
+    constexpr size_type size() const noexcept;
+
+    constexpr bool empty() const noexcept;
+
+    constexpr T& operator[](size_type index) const noexcept;
+
+    constexpr iterator begin() const noexcept;
+
+    constexpr iterator end() const noexcept;
+
+    constexpr span first(size_type count) const noexcept;
+
+    constexpr span subspan(size_type offset, size_type count) const noexcept;
+
+private:
+    T* data_{nullptr};
+    size_type size_{0};
+};
+
+// span implementation
+
+template <typename T>
+constexpr span<T>::span(T* data, size_type size) noexcept
+    : data_{data}
+    , size_{size}
+{
+}
+
+template <typename T>
+template <std::size_t N>
+constexpr span<T>::span(T (&arr)[N]) noexcept
+    : data_{arr}
+    , size_{N}
+{
+}
+
+template <typename T>
+template <typename Container, typename, typename>
+constexpr span<T>::span(Container& container) noexcept
+    : data_{container.data()}
+    , size_{container.size()}
+{
+}
+
+template <typename T>
+template <typename U, typename>
+constexpr span<T>::span(const span<U>& other) noexcept
+    : data_{other.data()}
+    , size_{other.size()}
+{
+}
+
+template <typename T> constexpr T* span<T>::data() const noexcept
+{
+    return data_;
+}
+
+template <typename T>
+constexpr typename span<T>::size_type span<T>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T> constexpr bool span<T>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename T>
+constexpr T& span<T>::operator[](size_type index) const noexcept
+{
+    return data_[index];
+}
+
+template <typename T>
+constexpr typename span<T>::iterator span<T>::begin() const noexcept
+{
+    return data_;
+}
+
+template <typename T>
+constexpr typename span<T>::iterator span<T>::end() const noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T>
+constexpr span<T> span<T>::first(size_type count) const noexcept
+{
+    return span{data_, count};
+}
+
+template <typename T>
+constexpr span<T> span<T>::subspan(size_type offset,
+                                   size_type count) const noexcept
+{
+    return span{data_ + offset, count};
+}
+
+} // namespace dw
+
+#endif /* end of include guard: SPAN_H_M3T7RQ0C */
@@ -0,0 +1,446 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef STATS_H_H4QJ7VMP
+#define STATS_H_H4QJ7VMP
+
+#include "parallel.h"
+#include "range.h"
+#include "span.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dw {
+
+/* Streaming count, sum, min, max, mean and quantiles of durations.
+ *
+ * Quantiles come from a DDSketch: durations are counted in buckets whose
+ * bounds grow geometrically, so any quantile is reported within
+ * relative_accuracy of the exact value, using memory logarithmic in the
+ * ratio of largest to smallest duration (about 2200 buckets for 1% accuracy
+ * and the whole nanosecond range). Negative durations are counted in a
+ * mirrored set of buckets.
+ *
+ * Accumulators with equal relative_accuracy merge exactly, so events can be
+ * accumulated per thread and merged, see make_duration_stats, and
+ * serialize / deserialize move them between processes. Durations are
+ * converted to nanoseconds and must fit into them.
+ */
+class DurationStats {
+public:
+    /* Throws std::invalid_argument if relative_accuracy is not in (0, 1). */
+    explicit DurationStats(double relative_accuracy = 0.01);
+
+    double relative_accuracy() const noexcept;
+
+    std::uint64_t count() const noexcept;
+
+    /* Sum is kept exactly and converted to seconds on return. */
+    std::chrono::duration<double> sum() const noexcept;
+
+    /* min, max, mean and quantile return zero if count() is 0. */
+    std::chrono::nanoseconds min() const noexcept;
+
+    std::chrono::nanoseconds max() const noexcept;
+
+    std::chrono::nanoseconds mean() const noexcept;
+
+    /* Returns value of q-quantile, i.e. 0.5 for median, within
+     * relative_accuracy(). Quantiles 0 and 1 are exact min and max.
+     * Throws std::invalid_argument if q is not in [0, 1]. */
+    std::chrono::nanoseconds quantile(double q) const;
+
+    template <typename Rep, typename Period>
+    void add(std::chrono::duration<Rep, Period> duration);
+
+    /* Adds range.duration(). */
+    void add(const DateTimeRange& range);
+
+    void add(span<const DateTimeRange> ranges);
+
+    /* Adds statistics of other accumulator to this one.
+     * Throws std::invalid_argument if relative accuracies differ. */
+    void merge(const DurationStats& other);
+
+    /* Returns compact binary form that doesn't depend on platform. */
+    std::string serialize() const;
+
+    /* Throws std::invalid_argument if bytes are not produced by serialize().
+     */
+    static DurationStats deserialize(std::string_view bytes);
+
+private:
+    static constexpr std::int64_t nanos_per_second{1'000'000'000};
+
+    double relative_accuracy_;
+    double gamma_;
+    double log_gamma_;
+    std::uint64_t count_{0};
+    std::uint64_t zero_count_{0};
+    // Sum is sum_seconds_ seconds plus sum_nanos_ nanoseconds
+    std::int64_t sum_seconds_{0};
+    std::int64_t sum_nanos_{0};
+    std::int64_t min_{0};
+    std::int64_t max_{0};
+    // Bucket k counts magnitudes in (gamma^(k - 1), gamma^k]
+    std::vector<std::uint64_t> positive_;
+    std::vector<std::uint64_t> negative_;
+
+    void add_nanos(std::int64_t nanos);
+
+    std::size_t bucket(std::uint64_t magnitude) const noexcept;
+
+    double bucket_value(std::size_t index) const noexcept;
+};
+
+/* Accumulates durations of ranges on concurrency threads and merges the
+ * per-thread results. Concurrency of 0 means
+ * std::thread::hardware_concurrency(). Small inputs are processed on the
+ * calling thread.
+ * Throws std::invalid_argument if relative_accuracy is not in (0, 1). */
+DurationStats make_duration_stats(span<const DateTimeRange> ranges,
+                                  double relative_accuracy = 0.01,
+                                  unsigned concurrency = 0);
+
+namespace utils {
+
+void write_varint(std::string& out, std::uint64_t value);
+
+/* Reads varint at pos and advances pos past it.
+ * Throws std::invalid_argument if input ends or varint is too long. */
+std::uint64_t read_varint(std::string_view in, std::size_t& pos);
+
+constexpr std::uint64_t zigzag_encode(std::int64_t value) noexcept;
+
+constexpr std::int64_t zigzag_decode(std::uint64_t value) noexcept;
+
+} // namespace utils
+
+// DurationStats implementation
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE DurationStats::DurationStats(double relative_accuracy)
+    : relative_accuracy_{relative_accuracy}
+    , gamma_{(1 + relative_accuracy) / (1 - relative_accuracy)}
+    , log_gamma_{std::log(gamma_)}
+{
+    if (!(relative_accuracy > 0 && relative_accuracy < 1))
+        throw std::invalid_argument("relative accuracy must be in (0, 1)");
+}
+
+DW_OUT_OF_LINE double DurationStats::relative_accuracy() const noexcept
+{
+    return relative_accuracy_;
+}
+
+DW_OUT_OF_LINE std::uint64_t DurationStats::count() const noexcept
+{
+    return count_;
+}
+
+DW_OUT_OF_LINE std::chrono::duration<double> DurationStats::sum() const noexcept
+{
+    return std::chrono::duration<double>{
+        static_cast<double>(sum_seconds_)
+        + static_cast<double>(sum_nanos_) / nanos_per_second};
+}
+
+DW_OUT_OF_LINE std::chrono::nanoseconds DurationStats::min() const noexcept
+{
+    return std::chrono::nanoseconds{min_};
+}
+
+DW_OUT_OF_LINE std::chrono::nanoseconds DurationStats::max() const noexcept
+{
+    return std::chrono::nanoseconds{max_};
+}
+
+DW_OUT_OF_LINE std::chrono::nanoseconds DurationStats::mean() const noexcept
+{
+    if (count_ == 0)
+        return std::chrono::nanoseconds{0};
+    const long double total
+        = static_cast<long double>(sum_seconds_) * nanos_per_second
+          + static_cast<long double>(sum_nanos_);
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(
+        std::llround(total / static_cast<long double>(count_)))};
+}
+
+DW_OUT_OF_LINE std::chrono::nanoseconds DurationStats::quantile(double q) const
+{
+    if (!(q >= 0 && q <= 1))
+        throw std::invalid_argument("quantile must be in [0, 1]");
+    if (count_ == 0)
+        return std::chrono::nanoseconds{0};
+    if (q == 0)
+        return min();
+    if (q == 1)
+        return max();
+    const auto rank
+        = static_cast<std::uint64_t>(q * static_cast<double>(count_ - 1));
+    const auto clamp = [this](double value) {
+        return std::chrono::nanoseconds{std::clamp(
+            static_cast<std::int64_t>(std::llround(value)), min_, max_)};
+    };
+    // Negative values from the most negative one, then zeros and positives
+    std::uint64_t seen = 0;
+    for (std::size_t k = negative_.size(); k-- > 0;) {
+        seen += negative_[k];
+        if (seen > rank)
+            return clamp(-bucket_value(k));
+    }
+    seen += zero_count_;
+    if (seen > rank)
+        return std::chrono::nanoseconds{0};
+    for (std::size_t k = 0; k < positive_.size(); ++k) {
+        seen += positive_[k];
+        if (seen > rank)
+            return clamp(bucket_value(k));
+    }
+    return max();
+}
+
+#endif
+
+template <typename Rep, typename Period>
+void DurationStats::add(std::chrono::duration<Rep, Period> duration)
+{
+    add_nanos(std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                  .count());
+}
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE void DurationStats::add(const DateTimeRange& range)
+{
+    add_nanos(range.duration<std::chrono::nanoseconds>().count());
+}
+
+DW_OUT_OF_LINE void DurationStats::add(span<const DateTimeRange> ranges)
+{
+    for (const DateTimeRange& range : ranges)
+        add(range);
+}
+
+DW_OUT_OF_LINE void DurationStats::add_nanos(std::int64_t nanos)
+{
+    if (nanos == 0) {
+        ++zero_count_;
+    } else {
+        // Magnitude of the smallest int64 doesn't fit into int64
+        const std::uint64_t magnitude
+            = nanos > 0 ? static_cast<std::uint64_t>(nanos)
+                        : 0 - static_cast<std::uint64_t>(nanos);
+        auto& buckets = nanos > 0 ? positive_ : negative_;
+        const std::size_t k = bucket(magnitude);
+        if (k >= buckets.size())
+            buckets.resize(k + 1);
+        ++buckets[k];
+    }
+    min_ = count_ == 0 ? nanos : std::min(min_, nanos);
+    max_ = count_ == 0 ? nanos : std::max(max_, nanos);
+    ++count_;
+    sum_seconds_ += nanos / nanos_per_second;
+    sum_nanos_ += nanos % nanos_per_second;
+    if (sum_nanos_ >= nanos_per_second || sum_nanos_ <= -nanos_per_second) {
+        sum_seconds_ += sum_nanos_ / nanos_per_second;
+        sum_nanos_ %= nanos_per_second;
+    }
+}
+
+DW_OUT_OF_LINE std::size_t DurationStats::bucket(std::uint64_t magnitude) const
+    noexcept
+{
+    const double index
+        = std::ceil(std::log(static_cast<double>(magnitude)) / log_gamma_);
+    return index > 0 ? static_cast<std::size_t>(index) : 0;
+}
+
+DW_OUT_OF_LINE double DurationStats::bucket_value(std::size_t index) const
+    noexcept
+{
+    // Midpoint in relative terms of (gamma^(k - 1), gamma^k]
+    return 2 * std::pow(gamma_, static_cast<double>(index)) / (gamma_ + 1);
+}
+
+DW_OUT_OF_LINE void DurationStats::merge(const DurationStats& other)
+{
+    if (other.relative_accuracy_ != relative_accuracy_)
+        throw std::invalid_argument("relative accuracies differ");
+    if (other.count_ == 0)
+        return;
+    min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+    max_ = count_ == 0 ? other.max_ : std::max(max_, other.max_);
+    count_ += other.count_;
+    zero_count_ += other.zero_count_;
+    sum_seconds_ += other.sum_seconds_;
+    sum_nanos_ += other.sum_nanos_;
+    sum_seconds_ += sum_nanos_ / nanos_per_second;
+    sum_nanos_ %= nanos_per_second;
+    const auto add_buckets = [](std::vector<std::uint64_t>& to,
+                                const std::vector<std::uint64_t>& from) {
+        if (from.size() > to.size())
+            to.resize(from.size());
+        for (std::size_t k = 0; k < from.size(); ++k)
+            to[k] += from[k];
+    };
+    add_buckets(positive_, other.positive_);
+    add_buckets(negative_, other.negative_);
+}
+
+DW_OUT_OF_LINE std::string DurationStats::serialize() const
+{
+    // "DWS1", accuracy bits, then varints; buckets are mostly small counts
+    std::string out{"DWS1"};
+    std::uint64_t accuracy_bits;
+    static_assert(sizeof(accuracy_bits) == sizeof(relative_accuracy_),
+                  "double must have 64 bits");
+    std::memcpy(&accuracy_bits, &relative_accuracy_, sizeof(accuracy_bits));
+    for (unsigned shift = 0; shift < 64; shift += 8)
+        out.push_back(static_cast<char>((accuracy_bits >> shift) & 0xff));
+    utils::write_varint(out, count_);
+    utils::write_varint(out, zero_count_);
+    utils::write_varint(out, utils::zigzag_encode(sum_seconds_));
+    utils::write_varint(out, utils::zigzag_encode(sum_nanos_));
+    utils::write_varint(out, utils::zigzag_encode(min_));
+    utils::write_varint(out, utils::zigzag_encode(max_));
+    for (const auto* buckets : {&positive_, &negative_}) {
+        utils::write_varint(out, buckets->size());
+        for (const std::uint64_t value : *buckets)
+            utils::write_varint(out, value);
+    }
+    return out;
+}
+
+DW_OUT_OF_LINE DurationStats DurationStats::deserialize(std::string_view bytes)
+{
+    constexpr std::size_t header_size{12};
+    if (bytes.size() < header_size || bytes.substr(0, 4) != "DWS1")
+        throw std::invalid_argument("not a serialized DurationStats");
+    std::uint64_t accuracy_bits = 0;
+    for (unsigned i = 0; i < 8; ++i)
+        accuracy_bits |= static_cast<std::uint64_t>(
+                             static_cast<unsigned char>(bytes[4 + i]))
+                         << (8 * i);
+    double accuracy;
+    std::memcpy(&accuracy, &accuracy_bits, sizeof(accuracy));
+    DurationStats stats{accuracy};
+    std::size_t pos = header_size;
+    stats.count_ = utils::read_varint(bytes, pos);
+    stats.zero_count_ = utils::read_varint(bytes, pos);
+    stats.sum_seconds_ = utils::zigzag_decode(utils::read_varint(bytes, pos));
+    stats.sum_nanos_ = utils::zigzag_decode(utils::read_varint(bytes, pos));
+    stats.min_ = utils::zigzag_decode(utils::read_varint(bytes, pos));
+    stats.max_ = utils::zigzag_decode(utils::read_varint(bytes, pos));
+    std::uint64_t total = stats.zero_count_;
+    for (auto* buckets : {&stats.positive_, &stats.negative_}) {
+        const std::uint64_t size = utils::read_varint(bytes, pos);
+        // Every bucket takes at least one byte
+        if (size > bytes.size() - pos)
+            throw std::invalid_argument("truncated DurationStats");
+        buckets->resize(static_cast<std::size_t>(size));
+        for (auto& value : *buckets) {
+            value = utils::read_varint(bytes, pos);
+            total += value;
+        }
+    }
+    if (pos != bytes.size() || total != stats.count_)
+        throw std::invalid_argument("inconsistent DurationStats");
+    return stats;
+}
+
+DW_OUT_OF_LINE DurationStats
+make_duration_stats(span<const DateTimeRange> ranges,
+                    double relative_accuracy,
+                    unsigned concurrency)
+{
+    std::vector<DurationStats> locals(
+        concurrency == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                         : concurrency,
+        DurationStats{relative_accuracy});
+    const std::size_t chunks = utils::for_each_chunk(
+        ranges.size(),
+        static_cast<unsigned>(locals.size()),
+        [&](std::size_t chunk, std::size_t first, std::size_t last) {
+            locals[chunk].add(ranges.subspan(first, last - first));
+        });
+    for (std::size_t i = 1; i < chunks; ++i)
+        locals.front().merge(locals[i]);
+    return std::move(locals.front());
+}
+
+#endif
+
+namespace utils {
+
+#if DW_DEFINE_OUT_OF_LINE
+
+DW_OUT_OF_LINE void write_varint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+DW_OUT_OF_LINE std::uint64_t read_varint(std::string_view in, std::size_t& pos)
+{
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size())
+            throw std::invalid_argument("truncated varint");
+        const auto byte = static_cast<unsigned char>(in[pos++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+    throw std::invalid_argument("varint is too long");
+}
+
+#endif
+
+inline constexpr std::uint64_t zigzag_encode(std::int64_t value) noexcept
+{
+    return (static_cast<std::uint64_t>(value) << 1)
+           ^ (value < 0 ? ~std::uint64_t{0} : 0);
+}
+
+inline constexpr std::int64_t zigzag_decode(std::uint64_t value) noexcept
+{
+    return static_cast<std::int64_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: STATS_H_H4QJ7VMP */
@@ -0,0 +1,271 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef TSC_CLOCK_H_F8DQ3WLA
+#define TSC_CLOCK_H_F8DQ3WLA
+
+#include "core.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DW_HAS_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#define DW_HAS_TSC 1
+#include <intrin.h>
+#else
+#define DW_HAS_TSC 0
+#endif
+
+namespace dw {
+
+/* Wall clock that converts time stamp counter readings to system_clock time.
+ *
+ * Reading TSC is cheaper than clock_gettime, even through vDSO. Counter rate
+ * is calibrated against system_clock on construction, which takes about
+ * 10 ms, and again once recalibration_interval has passed since the last
+ * calibration, so adjustments of system time are followed with that delay.
+ * Time may step back by calibration error on recalibration, so the clock is
+ * not steady.
+ *
+ * When TSC is not invariant, that is its rate follows CPU frequency or it
+ * stops in sleep states, or when CPU is not x86, readings come from
+ * system_clock.
+ *
+ * now() is thread-safe and readers don't block each other.
+ * Throws std::invalid_argument if recalibration_interval is not in (0, 2s].
+ */
+class TscClock {
+public:
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point =
+        std::chrono::time_point<std::chrono::system_clock, duration>;
+
+    static constexpr bool is_steady = false;
+
+    explicit TscClock(
+        duration recalibration_interval = std::chrono::seconds{1});
+
+    TscClock(const TscClock&) = delete;
+
+    TscClock& operator=(const TscClock&) = delete;
+
+    time_point now() noexcept;
+
+    /* Returns true when readings come from TSC. */
+    bool uses_tsc() const noexcept;
+
+private:
+    struct Sample {
+        std::uint64_t ticks;
+        std::int64_t nanos;
+    };
+
+    // Nanoseconds per tick are stored as fixed point with 32 fraction bits
+    static constexpr unsigned fraction_bits{32};
+
+    bool invariant_;
+    std::int64_t recalibration_nanos_;
+    Sample anchor_{0, 0};
+    std::atomic<bool> calibrating_{false};
+
+    // Seqlock protected calibration, odd sequence means update in progress
+    std::atomic<std::uint32_t> sequence_{0};
+    std::atomic<std::uint64_t> base_ticks_{0};
+    std::atomic<std::int64_t> base_nanos_{0};
+    std::atomic<std::uint64_t> multiplier_{0};
+    std::atomic<std::int64_t> recalibration_ticks_{0};
+
+    static Sample sample() noexcept;
+
+    static time_point system_now() noexcept;
+
+    /* Measures rate since anchor_ and publishes new calibration; after a
+     * backward step only the base moves. Caller must own calibrating_. */
+    void calibrate() noexcept;
+};
+
+/* Returns current DateTime read from clock. */
+DateTime current_date_time(TscClock& clock) noexcept;
+
+namespace utils {
+
+/* Returns true when CPU reports invariant TSC. */
+bool has_invariant_tsc() noexcept;
+
+/* Returns TSC value or 0 when CPU is not x86. */
+std::uint64_t read_tsc() noexcept;
+
+} // namespace utils
+
+// TscClock implementation
+
+inline TscClock::TscClock(duration recalibration_interval)
+    : invariant_{utils::has_invariant_tsc()}
+    , recalibration_nanos_{recalibration_interval.count()}
+{
+    // Longer interval would overflow ticks * multiplier_
+    if (recalibration_interval <= duration::zero()
+        || recalibration_interval > std::chrono::seconds{2})
+        throw std::invalid_argument(
+            "recalibration interval must be in (0, 2s]");
+    if (!invariant_)
+        return;
+    anchor_ = sample();
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    calibrate();
+}
+
+inline TscClock::time_point TscClock::now() noexcept
+{
+    if (!invariant_)
+        return system_now();
+    const std::uint64_t ticks = utils::read_tsc();
+    std::uint32_t sequence;
+    std::uint64_t base_ticks;
+    std::int64_t base_nanos;
+    std::uint64_t multiplier;
+    std::int64_t recalibration_ticks;
+    do {
+        sequence = sequence_.load(std::memory_order_acquire);
+        base_ticks = base_ticks_.load(std::memory_order_relaxed);
+        base_nanos = base_nanos_.load(std::memory_order_relaxed);
+        multiplier = multiplier_.load(std::memory_order_relaxed);
+        recalibration_ticks
+            = recalibration_ticks_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0
+             || sequence != sequence_.load(std::memory_order_relaxed));
+
+    const auto elapsed = static_cast<std::int64_t>(ticks - base_ticks);
+    if (elapsed < 0 || elapsed > recalibration_ticks) {
+        if (!calibrating_.exchange(true, std::memory_order_acquire)) {
+            calibrate();
+            calibrating_.store(false, std::memory_order_release);
+        }
+        return system_now();
+    }
+    const auto nanos = static_cast<std::int64_t>(
+        (static_cast<std::uint64_t>(elapsed) * multiplier) >> fraction_bits);
+    return time_point{duration{base_nanos + nanos}};
+}
+
+inline bool TscClock::uses_tsc() const noexcept { return invariant_; }
+
+inline TscClock::Sample TscClock::sample() noexcept
+{
+    // Pair system time with the middle of the shortest of a few reads
+    Sample best{0, 0};
+    std::uint64_t best_gap{~std::uint64_t{0}};
+    for (int i = 0; i < 5; ++i) {
+        const std::uint64_t before = utils::read_tsc();
+        const std::int64_t nanos = system_now().time_since_epoch().count();
+        const std::uint64_t gap = utils::read_tsc() - before;
+        if (gap < best_gap) {
+            best_gap = gap;
+            best = Sample{before + gap / 2, nanos};
+        }
+    }
+    return best;
+}
+
+inline TscClock::time_point TscClock::system_now() noexcept
+{
+    return std::chrono::time_point_cast<duration>(
+        std::chrono::system_clock::now());
+}
+
+inline void TscClock::calibrate() noexcept
+{
+    const Sample current = sample();
+    auto multiplier = multiplier_.load(std::memory_order_relaxed);
+    auto recalibration_ticks
+        = recalibration_ticks_.load(std::memory_order_relaxed);
+    // When system clock or counter stepped back, keep previous rate and only
+    // move the base, otherwise every later now() would recalibrate again
+    if (current.ticks > anchor_.ticks && current.nanos > anchor_.nanos) {
+        const double nanos_per_tick
+            = static_cast<double>(current.nanos - anchor_.nanos)
+              / static_cast<double>(current.ticks - anchor_.ticks);
+        multiplier = static_cast<std::uint64_t>(
+            nanos_per_tick * static_cast<double>(1ULL << fraction_bits));
+        recalibration_ticks = static_cast<std::int64_t>(
+            static_cast<double>(recalibration_nanos_) / nanos_per_tick);
+    }
+    anchor_ = current;
+
+    const std::uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_ticks_.store(current.ticks, std::memory_order_relaxed);
+    base_nanos_.store(current.nanos, std::memory_order_relaxed);
+    multiplier_.store(multiplier, std::memory_order_relaxed);
+    recalibration_ticks_.store(recalibration_ticks, std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+inline DateTime current_date_time(TscClock& clock) noexcept
+{
+    return DateTime{clock.now()};
+}
+
+namespace utils {
+
+inline bool has_invariant_tsc() noexcept
+{
+#if DW_HAS_TSC && defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, static_cast<int>(0x80000000));
+    if (static_cast<unsigned>(registers[0]) < 0x80000007u)
+        return false;
+    __cpuid(registers, static_cast<int>(0x80000007));
+    return (static_cast<unsigned>(registers[3]) & (1u << 8)) != 0;
+#elif DW_HAS_TSC
+    unsigned eax{0}, ebx{0}, ecx{0}, edx{0};
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+        return false;
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+inline std::uint64_t read_tsc() noexcept
+{
+#if DW_HAS_TSC
+    return static_cast<std::uint64_t>(__rdtsc());
+#else
+    return 0;
+#endif
+}
+
+} // namespace utils
+
+} // namespace dw
+
+#endif /* end of include guard: TSC_CLOCK_H_F8DQ3WLA */
@@ -0,0 +1,360 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#ifndef WINDOW_H_R4TZ9PLC
+#define WINDOW_H_R4TZ9PLC
+
+#include "range.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+
+namespace dw {
+
+/* Length of a stream window: either fixed duration, aligned to the Unix
+ * epoch, or a calendar day, ISO week or month, aligned to its first
+ * midnight. */
+class WindowLength {
+public:
+    using duration = std::chrono::system_clock::duration;
+
+    template <typename Rep, typename Period>
+    constexpr WindowLength(
+        const std::chrono::duration<Rep, Period>& fixed) noexcept;
+
+    constexpr WindowLength(BucketUnit unit) noexcept;
+
+    constexpr bool is_calendar() const noexcept;
+
+    /* Returns start of the window that contains dt. */
+    DateTime floor(const DateTime& dt) const noexcept;
+
+    /* Returns dt advanced by one length. Calendar lengths keep time of day
+     * and clamp day of month. */
+    DateTime next(const DateTime& dt) const noexcept;
+
+    /* Returns dt moved back by one length. */
+    DateTime prev(const DateTime& dt) const noexcept;
+
+private:
+    duration fixed_;
+    BucketUnit unit_;
+    bool calendar_;
+};
+
+enum class WindowKind { Tumbling, Sliding, Session };
+
+/* Window closed by WindowAssigner. Range is half-open: start is included,
+ * finish is not. */
+struct Window {
+    DateTimeRange range;
+    std::uint64_t events;
+};
+
+/* Groups stream of events into tumbling, sliding or session windows.
+ *
+ * Events are expected in nondecreasing order of time. An event earlier than
+ * the latest one is counted by windows that are still open, and by dropped()
+ * if there are none. A window closes as soon as an event at or after its
+ * finish arrives, or when advance_to() or flush() is called; closed windows
+ * queue up until drain() hands them out, so the assigner keeps only open
+ * windows between drains. Tumbling and session assignment is O(1) per event,
+ * sliding assignment is O(1) per window the event belongs to.
+ */
+class WindowAssigner {
+public:
+    /* Throws std::invalid_argument if a fixed length isn't positive or if
+     * session gap is a calendar length. */
+    WindowAssigner(WindowKind kind, WindowLength size, WindowLength slide);
+
+    WindowKind kind() const noexcept;
+
+    void add(const DateTime& event);
+
+    /* Closes windows that finish at or before watermark. */
+    void advance_to(const DateTime& watermark);
+
+    /* Closes all open windows. */
+    void flush();
+
+    /* Calls fn(const Window&) for each closed window in the order they were
+     * closed, forgets them and returns their number. */
+    template <typename Fn> std::size_t drain(Fn fn);
+
+    std::size_t open_windows() const noexcept;
+
+    /* Returns number of late events that didn't fall into any open window. */
+    std::uint64_t dropped() const noexcept;
+
+private:
+    struct OpenWindow {
+        DateTime start;
+        DateTime finish;
+        std::uint64_t events;
+    };
+
+    WindowKind kind_;
+    WindowLength size_;
+    WindowLength slide_;
+    std::deque<OpenWindow> open_;
+    std::deque<Window> closed_;
+    std::uint64_t dropped_{0};
+    bool started_{false};
+    DateTime watermark_;
+
+    void close_front();
+    void add_session(const DateTime& event);
+};
+
+/* Windows of size length that don't overlap. */
+WindowAssigner make_tumbling_windows(WindowLength size);
+
+/* Windows of size length that start every slide. */
+WindowAssigner make_sliding_windows(WindowLength size, WindowLength slide);
+
+/* Windows that extend while events are less than gap apart. */
+WindowAssigner make_session_windows(WindowLength::duration gap);
+
+// WindowLength implementation
+
+template <typename Rep, typename Period>
+inline constexpr WindowLength::WindowLength(
+    const std::chrono::duration<Rep, Period>& fixed) noexcept
+    : fixed_{std::chrono::duration_cast<duration>(fixed)}
+    , unit_{BucketUnit::Day}
+    , calendar_{false}
+{
+}
+
+constexpr WindowLength::WindowLength(BucketUnit unit) noexcept
+    : fixed_{duration::zero()}
+    , unit_{unit}
+    , calendar_{true}
+{
+}
+
+constexpr bool WindowLength::is_calendar() const noexcept
+{
+    return calendar_;
+}
+
+inline DateTime WindowLength::floor(const DateTime& dt) const noexcept
+{
+    if (!calendar_) {
+        const duration since_epoch{to_time_point<duration>(dt)
+                                       .time_since_epoch()};
+        duration offset{since_epoch % fixed_};
+        if (offset < duration::zero())
+            offset += fixed_;
+        return dt - offset;
+    }
+    switch (unit_) {
+    case BucketUnit::Day:
+        break;
+    case BucketUnit::IsoWeek:
+        return DateTime{prev_weekday(dt.date(), Weekday::Monday)};
+    case BucketUnit::Month:
+        return DateTime{Date{dt.year(), dt.month(), Day{1}}};
+    }
+    return DateTime{dt.date()};
+}
+
+inline DateTime WindowLength::next(const DateTime& dt) const noexcept
+{
+    if (!calendar_)
+        return dt + fixed_;
+    switch (unit_) {
+    case BucketUnit::Day:
+        break;
+    case BucketUnit::IsoWeek:
+        return dt + Weeks{1};
+    case BucketUnit::Month:
+        return dt + Months{1};
+    }
+    return dt + Days{1};
+}
+
+inline DateTime WindowLength::prev(const DateTime& dt) const noexcept
+{
+    if (!calendar_)
+        return dt - fixed_;
+    switch (unit_) {
+    case BucketUnit::Day:
+        break;
+    case BucketUnit::IsoWeek:
+        return dt - Weeks{1};
+    case BucketUnit::Month:
+        return dt - Months{1};
+    }
+    return dt - Days{1};
+}
+
+// WindowAssigner implementation
+
+inline WindowAssigner::WindowAssigner(WindowKind kind,
+                                      WindowLength size,
+                                      WindowLength slide)
+    : kind_{kind}
+    , size_{size}
+    , slide_{kind == WindowKind::Sliding ? slide : size}
+    , watermark_{Date{Year{1970}, Month{1}, Day{1}}}
+{
+    const DateTime epoch{watermark_};
+    if (size_.next(epoch) <= epoch || slide_.next(epoch) <= epoch)
+        throw std::invalid_argument("window length must be positive");
+    if (kind_ == WindowKind::Session && size_.is_calendar())
+        throw std::invalid_argument("session gap must be a fixed duration");
+}
+
+inline WindowKind WindowAssigner::kind() const noexcept { return kind_; }
+
+inline void WindowAssigner::add(const DateTime& event)
+{
+    if (kind_ == WindowKind::Session) {
+        add_session(event);
+        return;
+    }
+    if (started_ && event < watermark_) {
+        bool assigned = false;
+        for (auto& window : open_) {
+            if (window.start <= event && event < window.finish) {
+                ++window.events;
+                assigned = true;
+            }
+        }
+        if (!assigned)
+            ++dropped_;
+        return;
+    }
+    advance_to(event);
+    // Starts of windows that contain the event, latest first
+    DateTime start{slide_.floor(event)};
+    const std::size_t known = open_.size();
+    while (size_.next(start) > event) {
+        if (known != 0 && start <= open_.back().start)
+            break;
+        open_.push_back(OpenWindow{start, size_.next(start), 0});
+        start = slide_.prev(start);
+    }
+    std::reverse(open_.begin() + static_cast<std::ptrdiff_t>(known),
+                 open_.end());
+    for (auto window = open_.rbegin();
+         window != open_.rend() && window->start <= event;
+         ++window) {
+        if (event < window->finish)
+            ++window->events;
+    }
+}
+
+inline void WindowAssigner::add_session(const DateTime& event)
+{
+    if (open_.empty()) {
+        if (started_ && event < watermark_) {
+            ++dropped_;
+            return;
+        }
+        started_ = true;
+        watermark_ = event;
+        open_.push_back(OpenWindow{event, size_.next(event), 1});
+        return;
+    }
+    OpenWindow& session = open_.front();
+    if (event < session.start) {
+        ++dropped_;
+        return;
+    }
+    if (event >= session.finish) {
+        close_front();
+        add_session(event);
+        return;
+    }
+    ++session.events;
+    if (size_.next(event) > session.finish)
+        session.finish = size_.next(event);
+    if (event > watermark_)
+        watermark_ = event;
+}
+
+inline void WindowAssigner::advance_to(const DateTime& watermark)
+{
+    if (started_ && watermark < watermark_)
+        return;
+    started_ = true;
+    watermark_ = watermark;
+    while (!open_.empty() && open_.front().finish <= watermark_)
+        close_front();
+}
+
+inline void WindowAssigner::flush()
+{
+    while (!open_.empty())
+        close_front();
+}
+
+template <typename Fn> std::size_t WindowAssigner::drain(Fn fn)
+{
+    const std::size_t count = closed_.size();
+    while (!closed_.empty()) {
+        const Window& window = closed_.front();
+        fn(window);
+        closed_.pop_front();
+    }
+    return count;
+}
+
+inline std::size_t WindowAssigner::open_windows() const noexcept
+{
+    return open_.size();
+}
+
+inline std::uint64_t WindowAssigner::dropped() const noexcept
+{
+    return dropped_;
+}
+
+inline void WindowAssigner::close_front()
+{
+    const OpenWindow& window = open_.front();
+    closed_.push_back(
+        Window{DateTimeRange{window.start, window.finish}, window.events});
+    open_.pop_front();
+}
+
+inline WindowAssigner make_tumbling_windows(WindowLength size)
+{
+    return WindowAssigner{WindowKind::Tumbling, size, size};
+}
+
+inline WindowAssigner make_sliding_windows(WindowLength size,
+                                           WindowLength slide)
+{
+    return WindowAssigner{WindowKind::Sliding, size, slide};
+}
+
+inline WindowAssigner make_session_windows(WindowLength::duration gap)
+{
+    return WindowAssigner{WindowKind::Session, gap, gap};
+}
+
+} // namespace dw
+
+#endif /* end of include guard: WINDOW_H_R4TZ9PLC */
@@ -0,0 +1,31 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#define DATE_WRAPPER_IMPL
+
+#include "date_wrapper/core.h"
+#include "date_wrapper/duration.h"
+#include "date_wrapper/fiscal.h"
+#include "date_wrapper/format.h"
+#include "date_wrapper/io.h"
+#include "date_wrapper/range.h"
+#include "date_wrapper/rle.h"
+#include "date_wrapper/stats.h"
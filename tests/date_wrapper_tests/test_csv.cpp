@@ -0,0 +1,135 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/csv.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+TEST(Csv, writes_date_ranges)
+{
+    std::ostringstream os;
+    {
+        DateRangeCsvWriter writer{os};
+        writer.write(DateRange{"2019-05-01"_date, "2019-05-31"_date});
+        writer.write(DateRange{"2019-06-01"_date, "2019-06-30"_date});
+    }
+    EXPECT_EQ(os.str(),
+              "2019-05-01,2019-05-31\n"
+              "2019-06-01,2019-06-30\n");
+}
+
+TEST(Csv, writer_flushes_full_chunks)
+{
+    std::ostringstream os;
+    DateRangeCsvWriter writer{os, "yyyy-MM-dd", ';', 1};
+    writer.write(DateRange{"2019-05-01"_date, "2019-05-31"_date});
+    writer.write(DateRange{"2019-06-01"_date, "2019-06-30"_date});
+    EXPECT_EQ(os.str(), "2019-05-01;2019-05-31\n");
+    writer.flush();
+    EXPECT_EQ(os.str(),
+              "2019-05-01;2019-05-31\n"
+              "2019-06-01;2019-06-30\n");
+}
+
+TEST(Csv, date_time_ranges_round_trip)
+{
+    const DateTime start{"2019-05-10T10:00:00.000000250Z"_dt};
+    std::vector<DateTimeRange> ranges;
+    for (int i = 0; i < 100; ++i)
+        ranges.emplace_back(start + std::chrono::hours{i},
+                            start + std::chrono::hours{i} + 90s);
+    std::ostringstream os;
+    {
+        DateTimeRangeCsvWriter writer{os};
+        writer.write(span<const DateTimeRange>{ranges});
+    }
+    EXPECT_EQ(os.str().substr(0, 60),
+              "2019-05-10T10:00:00.000000250,2019-05-10T10:01:30.000000250\n");
+
+    const auto result = read_csv<DateTimeRange>(os.str());
+    EXPECT_TRUE(result.errors.empty());
+    EXPECT_EQ(result.rows, ranges);
+}
+
+TEST(Csv, reports_bad_rows)
+{
+    const std::string input{"2019-05-01,2019-05-31\r\n"
+                            "\n"
+                            "2019-05-01 2019-05-31\n"
+                            "2019-02-30,2019-05-31\n"
+                            "2019-06-01,2019-06-30"};
+    const auto result = read_csv<DateRange>(input);
+
+    ASSERT_EQ(result.rows.size(), 2u);
+    EXPECT_EQ(result.rows[1],
+              (DateRange{"2019-06-01"_date, "2019-06-30"_date}));
+    ASSERT_EQ(result.errors.size(), 2u);
+    EXPECT_EQ(result.errors[0].line, 3u);
+    EXPECT_EQ(result.errors[0].message, "delimiter expected");
+    EXPECT_EQ(result.errors[1].line, 4u);
+    EXPECT_EQ(result.errors[1].message, "invalid date");
+}
+
+TEST(Csv, parallel_read_matches_sequential)
+{
+    std::string input;
+    for (int i = 0; i < 20000; ++i) {
+        const Date date{"2000-01-01"_date + Days{i}};
+        input += to_string(date, "yyyy-MM-dd") + ","
+                 + to_string(date + Days{1}, "yyyy-MM-dd") + "\n";
+        if (i % 1000 == 0)
+            input += "bad row\n";
+    }
+
+    const auto sequential = read_csv<DateRange>(input, ',', 1);
+    const auto parallel = read_csv<DateRange>(input, ',', 4);
+
+    EXPECT_EQ(parallel.rows.size(), 20000u);
+    EXPECT_EQ(parallel.rows, sequential.rows);
+    ASSERT_EQ(parallel.errors.size(), sequential.errors.size());
+    for (std::size_t i = 0; i < parallel.errors.size(); ++i)
+        EXPECT_EQ(parallel.errors[i].line, sequential.errors[i].line);
+    // Bad row follows 19001 rows and 19 earlier bad rows
+    EXPECT_EQ(parallel.errors.back().line, 19021u);
+}
+
+TEST(Csv, reader_joins_rows_split_between_chunks)
+{
+    const std::string input{"2019-05-01,2019-05-31\n"
+                            "2019-06-01,2019-06-30\n"
+                            "2019-07-01,2019-07-31"};
+    CsvReader<DateRange> reader;
+    CsvReadResult<DateRange> result;
+    for (std::size_t first = 0; first < input.size(); first += 7)
+        reader.feed(std::string_view{input}.substr(first, 7), result);
+    reader.finish(result);
+
+    EXPECT_TRUE(result.errors.empty());
+    ASSERT_EQ(result.rows.size(), 3u);
+    EXPECT_EQ(result.rows[2],
+              (DateRange{"2019-07-01"_date, "2019-07-31"_date}));
+}
@@ -22,6 +22,13 @@
 #include "date_wrapper/date_wrapper.h"
 #include "gtest/gtest.h"
 
+#include <sstream>
+
+// Helper macros of the literals must not leak into user code
+#ifdef DW_CONSTEVAL
+#error "DW_CONSTEVAL is defined after including date_wrapper.h"
+#endif
+
 using namespace dw;
 
 TEST(Date, constructs_from_YMD)
@@ -218,6 +225,27 @@ TEST(Date, ostream_operator)
     EXPECT_EQ(expected, ss.str());
 }
 
+TEST(Date, ostream_operator_does_not_change_stream_fill)
+{
+    const Date date{Year{2019}, Month{8}, Day{7}};
+    std::stringstream ss;
+
+    ss << date << ' ' << std::setw(3) << 5;
+
+    EXPECT_EQ("07.08.2019   5", ss.str());
+    EXPECT_EQ(' ', ss.fill());
+}
+
+TEST(Date, wide_ostream_operator)
+{
+    const Date date{Year{2019}, Month{8}, Day{7}};
+    std::wstringstream ss;
+
+    ss << date;
+
+    EXPECT_EQ(L"07.08.2019", ss.str());
+}
+
 TEST(Date, to_string_handles_valid_date_format)
 {
     const Date date{Year{2016}, Month{9}, Day{21}};
@@ -230,6 +258,24 @@ TEST(Date, to_string_handles_valid_date_format)
     EXPECT_EQ("099", to_string(date, "MMM"));
 }
 
+TEST(Date, to_string_handles_unnormalized_date)
+{
+    const Date date{Year{2019}, Month{200}, Day{200}};
+
+    EXPECT_EQ("200.200.200.200.200.200", to_string(date, "dd.MM.dd.MM.dd.MM"));
+    EXPECT_EQ("200.200", to_string(date, "d.M"));
+    std::ostringstream os;
+    os << date;
+    EXPECT_EQ("200.200.2019", os.str());
+}
+
+TEST(Date, to_string_treats_time_expressions_as_text)
+{
+    constexpr Date date{Year{2016}, Month{9}, Day{21}};
+
+    EXPECT_EQ("21 hh:mm:ss.zzz AP", to_string(date, "d hh:mm:ss.zzz AP"));
+}
+
 TEST(Date, to_string_ignores_single_quote_that_has_no_pair)
 {
     const Date date{Year{2016}, Month{9}, Day{21}};
@@ -361,3 +407,20 @@ TEST(Date, converts_to_sys_days)
 
     static_assert(expected == sys_days(date));
 }
+
+TEST(Date, constructs_from_literal)
+{
+    constexpr Date date{"2019-05-10"_date};
+
+    static_assert(Date{Year{2019}, Month{5}, Day{10}} == date);
+    static_assert(Date{Year{2016}, Month{2}, Day{29}} == "2016-02-29"_date);
+}
+
+TEST(Date, parsing_throws_on_invalid_date_string)
+{
+    EXPECT_THROW(utils::parse_iso_date("2019-02-29"), std::invalid_argument);
+    EXPECT_THROW(utils::parse_iso_date("2019-13-01"), std::invalid_argument);
+    EXPECT_THROW(utils::parse_iso_date("2019/05/10"), std::invalid_argument);
+    EXPECT_THROW(utils::parse_iso_date("2019-5-10"), std::invalid_argument);
+    EXPECT_THROW(utils::parse_iso_date("2019-05-10 "), std::invalid_argument);
+}
@@ -22,6 +22,8 @@
 #include "gtest/gtest.h"
 #include <date_wrapper/date_wrapper.h>
 
+#include <vector>
+
 
 TEST(DateRangeSuite, returns_duration_in_days)
 {
@@ -63,3 +65,69 @@ TEST(DateRangeSuite, date_span_equality)
     static_assert(DateRange{start, finish} == DateRange{start, finish});
     static_assert(DateRange{start, start} != DateRange{start, finish});
 }
+
+TEST(DateRangeSuite, ostream_operator)
+{
+    using namespace dw;
+    const DateRange date_range{Date{Year{2019}, Month{1}, Day{7}},
+                               Date{Year{2019}, Month{3}, Day{11}}};
+    std::stringstream ss;
+
+    ss << date_range;
+
+    EXPECT_EQ("DateRange {07.01.2019 - 11.03.2019}", ss.str());
+}
+
+TEST(DateRangeSuite, counts_weekdays_arithmetically)
+{
+    using namespace dw;
+
+    // Wednesday to Monday, 13 days
+    constexpr DateRange range{Date{Year{2019}, Month{5}, Day{1}},
+                              Date{Year{2019}, Month{5}, Day{13}}};
+
+    static_assert(2 == count_weekday(range, Weekday::Monday));
+    static_assert(1 == count_weekday(range, Weekday::Tuesday));
+    static_assert(4 == count_weekdays(range, weekend_mask));
+    static_assert(9 == count_weekdays(range, working_days_mask));
+    static_assert(0 == count_weekdays(range, 0));
+    static_assert(1
+                  == count_weekday(DateRange{Date{Year{1969}, Month{12},
+                                                  Day{29}},
+                                             Date{Year{1969}, Month{12},
+                                                  Day{29}}},
+                                   Weekday::Monday));
+
+    const Date start{Year{2019}, Month{1}, Day{1}};
+    for (int length = 0; length < 30; ++length) {
+        const DateRange days{start + Days{length}, start};
+        long long expected = 0;
+        for (int i = 0; i <= length; ++i) {
+            const Weekday day = weekday(start + Days{i});
+            expected += day == Weekday::Friday || day == Weekday::Sunday;
+        }
+        EXPECT_EQ(expected,
+                  count_weekdays(days,
+                                 weekday_mask(Weekday::Friday)
+                                     | weekday_mask(Weekday::Sunday)));
+    }
+}
+
+TEST(DateRangeSuite, counts_weekdays_in_batches)
+{
+    using namespace dw;
+
+    const Date start{Year{2019}, Month{5}, Day{1}};
+    const std::vector<DateRange> ranges{DateRange{start, start + Days{6}},
+                                        DateRange{start, start + Days{2}}};
+    std::vector<long long> counts(ranges.size());
+
+    count_weekday(ranges, Weekday::Friday, counts);
+    EXPECT_EQ((std::vector<long long>{1, 1}), counts);
+
+    count_weekdays(ranges, weekend_mask, counts);
+    EXPECT_EQ((std::vector<long long>{2, 0}), counts);
+
+    EXPECT_THROW(count_weekdays(ranges, weekend_mask, span<long long>{}),
+                 std::invalid_argument);
+}
@@ -81,3 +81,49 @@ TEST(DateTimeRange, timespan_equality)
     static_assert(DateTimeRange(start, finish + 1s)
                   != DateTimeRange(start, finish));
 }
+
+TEST(DateTimeRange, ostream_operator)
+{
+    using namespace std::chrono_literals;
+    const auto start
+        = DateTime{Date{Year{2019}, Month{3}, Day{20}}} + 7h + 5min + 4s;
+    const DateTimeRange range{start, start + 26h};
+    std::stringstream ss;
+
+    ss << range;
+
+    EXPECT_EQ("DateTimeRange {20.03.2019 07:05:04, 21.03.2019 09:05:04}",
+              ss.str());
+}
+
+TEST(DateTimeRange, is_half_open_interval)
+{
+    using namespace std::chrono_literals;
+    constexpr auto start = DateTime{Date{Year{2019}, Month{3}, Day{20}}};
+    constexpr DateTimeRange range{start, start + 2h};
+    constexpr DateTimeRange reversed{start + 2h, start};
+
+    static_assert(canonical(reversed) == range);
+    static_assert(contains(range, start));
+    static_assert(contains(reversed, start + 1h));
+    static_assert(!contains(range, start + 2h));
+    static_assert(contains(range, DateTimeRange{start + 1h, start + 2h}));
+    static_assert(!contains(range, DateTimeRange{start + 1h, start + 3h}));
+    static_assert(contains(range, DateTimeRange{start + 5h, start + 5h}));
+    static_assert(!contains(DateTimeRange{start, start}, start));
+    static_assert(empty(DateTimeRange{start, start}));
+}
+
+TEST(DateTimeRange, overlaps_and_intersects)
+{
+    using namespace std::chrono_literals;
+    constexpr auto start = DateTime{Date{Year{2019}, Month{3}, Day{20}}};
+    constexpr DateTimeRange range{start, start + 2h};
+
+    static_assert(overlaps(range, DateTimeRange{start + 3h, start + 1h}));
+    static_assert(!overlaps(range, DateTimeRange{start + 2h, start + 3h}));
+    static_assert(!overlaps(range, DateTimeRange{start + 1h, start + 1h}));
+    static_assert(intersection(range, DateTimeRange{start + 3h, start + 1h})
+                  == DateTimeRange(start + 1h, start + 2h));
+    static_assert(!intersection(range, DateTimeRange{start - 1h, start}));
+}
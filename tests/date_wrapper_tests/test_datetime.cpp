@@ -272,6 +272,44 @@ TEST(DateTime, to_string_handles_time_format)
     EXPECT_EQ("0907", to_string(dt, "hhmm"));
 }
 
+TEST(DateTime, to_string_handles_fractional_seconds)
+{
+    constexpr auto dt = DateTime{Date{Year{2016}, Month{9}, Day{21}}} + 9h
+                        + 7min + 5s + 42ms + 7us + 3ns;
+
+    EXPECT_EQ("42", to_string(dt, "z"));
+    EXPECT_EQ("042", to_string(dt, "zzz"));
+    EXPECT_EQ("042007", to_string(dt, "zzzzzz"));
+    EXPECT_EQ("042007003", to_string(dt, "zzzzzzzzz"));
+    EXPECT_EQ("09:07:05.042", to_string(dt, "hh:mm:ss.zzz"));
+    EXPECT_EQ("0", to_string(dt - 42ms, "z"));
+}
+
+TEST(DateTime, to_string_handles_am_pm_display)
+{
+    constexpr DateTime midnight{Date{Year{2016}, Month{9}, Day{21}}};
+
+    EXPECT_EQ("12:00 AM", to_string(midnight, "hh:mm AP"));
+    EXPECT_EQ("9:30 am", to_string(midnight + 9h + 30min, "h:mm ap"));
+    EXPECT_EQ("12:00 PM", to_string(midnight + 12h, "hh:mm AP"));
+    EXPECT_EQ("11:59 pm", to_string(midnight + 23h + 59min, "h:mm ap"));
+    EXPECT_EQ("23", to_string(midnight + 23h, "h"));
+}
+
+TEST(DateTime, compiled_format_can_be_reused)
+{
+    const CompiledFormat format{"yyyy-MM-dd hh:mm:ss.zzz"};
+    constexpr auto dt
+        = DateTime{Date{Year{2016}, Month{9}, Day{21}}} + 9h + 7min + 5s;
+    char buffer[64];
+
+    char* end = format.format_to(buffer, dt + 1ms);
+
+    EXPECT_LE(static_cast<std::size_t>(end - buffer), format.max_size());
+    EXPECT_EQ("2016-09-21 09:07:05.001", std::string(buffer, end));
+    EXPECT_EQ("2016-09-21 09:07:05.000", format.format(dt));
+}
+
 TEST(DateTime, ignores_single_quote_that_has_no_pair)
 {
     constexpr DateTime dt{Date{Year{2016}, Month{9}, Day{21}}};
@@ -330,3 +368,68 @@ TEST(DateTime, returns_timestamp_in_years)
         == to_time_point<std::chrono::seconds>(dt).time_since_epoch());
 }
 
+
+TEST(DateTime, constructs_from_literal)
+{
+    constexpr DateTime dt{"2019-05-10T10:00:00Z"_dt};
+    constexpr DateTime with_fraction{"2019-05-10T23:59:59.25"_dt};
+
+    static_assert(DateTime{Date{Year{2019}, Month{5}, Day{10}}} + 10h == dt);
+    static_assert(DateTime{Date{Year{2019}, Month{5}, Day{10}}} + 23h + 59min
+                      + 59s + 250ms
+                  == with_fraction);
+}
+
+TEST(DateTime, parsing_throws_on_invalid_date_time_string)
+{
+    EXPECT_THROW(parse_iso_date_time("2019-05-10T24:00:00"),
+                 std::invalid_argument);
+    EXPECT_THROW(parse_iso_date_time("2019-05-10 10:00:00"),
+                 std::invalid_argument);
+    EXPECT_THROW(parse_iso_date_time("2019-05-10T10:00:00."),
+                 std::invalid_argument);
+    EXPECT_THROW(parse_iso_date_time("2019-05-10T10:00:00.0000000001"),
+                 std::invalid_argument);
+    EXPECT_THROW(parse_iso_date_time("2019-05-10T10:00:00+01:00"),
+                 std::invalid_argument);
+}
+
+TEST(BasicDateTime, second_precision_keeps_calendar_arithmetic)
+{
+    using SecondsDateTime = BasicDateTime<std::chrono::seconds>;
+    constexpr SecondsDateTime dt{Date{Year{2019}, Month{12}, Day{31}}, 23h};
+    constexpr SecondsDateTime next{dt + 90min + 500ms};
+
+    static_assert(sizeof(SecondsDateTime) < sizeof(DateTime));
+    static_assert(std::is_same_v<decltype(next.time()), seconds>);
+    static_assert(next.date() == Date{Year{2020}, Month{1}, Day{1}});
+    static_assert(next.hour() == 0h && next.minute() == 30min
+                  && next.second() == 0s);
+    static_assert(next.weekday() == Weekday::Wednesday);
+    constexpr Date last_month{Year{2019}, Month{11}, Day{30}};
+    static_assert(dt - Months{1} == SecondsDateTime{last_month, 23h});
+    static_assert(dt < next);
+    EXPECT_EQ("01.01.2020 00:30:00", to_string(next, "dd.MM.yyyy hh:mm:ss"));
+}
+
+TEST(BasicDateTime, converts_between_precisions_explicitly)
+{
+    constexpr DateTime dt{"2019-05-10T10:00:00.75"_dt};
+    const BasicDateTime<std::chrono::seconds> coarse{dt};
+    const DateTime fine{coarse};
+
+    EXPECT_EQ(10h, coarse.time());
+    EXPECT_EQ(DateTime{"2019-05-10T10:00:00"_dt}, fine);
+    EXPECT_FALSE((std::is_convertible_v<DateTime,
+                                        BasicDateTime<std::chrono::seconds>>));
+}
+
+TEST(BasicDateTime, conversion_throws_when_time_does_not_fit_precision)
+{
+    using ShortSeconds = std::chrono::duration<std::int16_t>;
+    constexpr DateTime late{"2019-05-10T23:00:00"_dt};
+    constexpr DateTime early{"2019-05-10T01:00:00"_dt};
+
+    EXPECT_THROW(BasicDateTime<ShortSeconds>{late}, std::overflow_error);
+    EXPECT_EQ(1h, BasicDateTime<ShortSeconds>{early}.time());
+}
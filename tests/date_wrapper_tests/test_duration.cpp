@@ -0,0 +1,124 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/duration.h>
+
+#include <stdexcept>
+#include <string>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+namespace {
+
+template <typename Duration> std::string humanized(Duration d, unsigned n = 2)
+{
+    char buffer[humanized_max_size];
+    return std::string(buffer, write_humanized(buffer, d, n));
+}
+
+template <typename Duration> std::string iso(Duration d)
+{
+    char buffer[iso_duration_max_size];
+    return std::string(buffer, write_iso_duration(buffer, d));
+}
+
+} // namespace
+
+TEST(DurationFormat, formats_fields)
+{
+    const auto duration = 24h * 2 + 3h + 14min + 7s + 250ms;
+
+    EXPECT_EQ(DurationFormat{"d'd' hh:mm:ss"}.format(duration),
+              "2d 03:14:07");
+    EXPECT_EQ(DurationFormat{"h'h' m'm'"}.format(1h + 5min), "1h 5m");
+    EXPECT_EQ(DurationFormat{"mm:ss.zzz"}.format(duration), "3074:07.250");
+    EXPECT_EQ(DurationFormat{"hh:mm"}.format(-duration), "-51:14");
+}
+
+TEST(DurationFormat, largest_unit_holds_the_rest)
+{
+    EXPECT_EQ(DurationFormat{"h:mm:ss"}.format(26h), "26:00:00");
+    EXPECT_EQ(DurationFormat{"m"}.format(26h), "1560");
+    EXPECT_EQ(DurationFormat{"d hh"}.format(26h), "1 02");
+}
+
+TEST(DurationFormat, formats_date_time_range)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{10}}};
+    const DurationFormat format{"d'd' hh:mm:ss"};
+    char buffer[64];
+    ASSERT_LE(format.max_size(), sizeof(buffer));
+
+    char* last = format.format_to(buffer, DateTimeRange{start + 26h, start});
+
+    EXPECT_EQ(std::string(buffer, last), "1d 02:00:00");
+}
+
+TEST(DurationFormat, writes_humanized_durations)
+{
+    EXPECT_EQ(humanized(24h * 2 + 3h + 14min + 7s), "2d 3h");
+    EXPECT_EQ(humanized(1h + 5min + 3s), "1h 5m");
+    EXPECT_EQ(humanized(1h + 5s), "1h");
+    EXPECT_EQ(humanized(1h + 5min + 3s, 3), "1h 5m 3s");
+    EXPECT_EQ(humanized(-250ms), "-250ms");
+    EXPECT_EQ(humanized(0s), "0s");
+}
+
+TEST(DurationFormat, writes_iso_durations)
+{
+    EXPECT_EQ(iso(24h * 2 + 3h + 14min + 7s), "P2DT3H14M7S");
+    EXPECT_EQ(iso(24h), "P1D");
+    EXPECT_EQ(iso(90min), "PT1H30M");
+    EXPECT_EQ(iso(250ms), "PT0.25S");
+    EXPECT_EQ(iso(0s), "PT0S");
+    EXPECT_EQ(iso(-1s), "-PT1S");
+}
+
+TEST(DurationFormat, parses_iso_durations)
+{
+    static_assert(parse_iso_duration("P2DT3H14M7S")
+                  == 24h * 2 + 3h + 14min + 7s);
+    static_assert(parse_iso_duration("PT0.25S") == 250ms);
+    static_assert(parse_iso_duration("P1W") == 24h * 7);
+    static_assert(parse_iso_duration("-PT1M") == -1min);
+    EXPECT_EQ(parse_iso_duration("PT1,5S"), 1500ms);
+
+    const std::chrono::nanoseconds durations[]
+        = {0ns, 1ns, 90min, 24h * 400 + 1s + 1ns, -36h};
+    for (const auto d : durations)
+        EXPECT_EQ(parse_iso_duration(iso(d)), d);
+}
+
+TEST(DurationFormat, rejects_invalid_iso_durations)
+{
+    EXPECT_THROW(parse_iso_duration(""), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("P"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("PT"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("P1DT"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("P1M"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("P1Y"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("PT1S1M"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("PT1.5M"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("PT1"), std::invalid_argument);
+    EXPECT_THROW(parse_iso_duration("P999999999D"), std::overflow_error);
+}
@@ -0,0 +1,150 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/fiscal.h>
+
+#include <vector>
+
+using namespace dw;
+
+TEST(FiscalCalendar, monthly_calendar_starting_in_april)
+{
+    const auto calendar
+        = make_monthly_calendar(Month{4}, Year{2019}, Year{2021});
+
+    EXPECT_EQ(calendar.range(),
+              (DateRange{Date{Year{2018}, Month{4}, Day{1}},
+                         Date{Year{2021}, Month{3}, Day{31}}}));
+    EXPECT_EQ(calendar.lookup(Date{Year{2019}, Month{7}, Day{15}}),
+              (FiscalPeriod{Year{2020}, 2, 4, 16}));
+    EXPECT_EQ(calendar.lookup(Date{Year{2020}, Month{3}, Day{31}}),
+              (FiscalPeriod{Year{2020}, 4, 12, 53}));
+    EXPECT_EQ(calendar.period_range(Year{2020}, 11),
+              (DateRange{Date{Year{2020}, Month{2}, Day{1}},
+                         Date{Year{2020}, Month{2}, Day{29}}}));
+    EXPECT_EQ(calendar.quarter_range(Year{2021}, 3),
+              (DateRange{Date{Year{2020}, Month{10}, Day{1}},
+                         Date{Year{2020}, Month{12}, Day{31}}}));
+    EXPECT_EQ(calendar.week_range(Year{2020}, 53),
+              (DateRange{Date{Year{2020}, Month{3}, Day{30}},
+                         Date{Year{2020}, Month{3}, Day{31}}}));
+}
+
+TEST(FiscalCalendar, monthly_calendar_starting_in_january_is_calendar_year)
+{
+    const auto calendar
+        = make_monthly_calendar(Month{1}, Year{2019}, Year{2019});
+
+    EXPECT_EQ(calendar.year_range(Year{2019}),
+              (DateRange{Date{Year{2019}, Month{1}, Day{1}},
+                         Date{Year{2019}, Month{12}, Day{31}}}));
+    EXPECT_EQ(calendar.lookup(Date{Year{2019}, Month{1}, Day{7}}),
+              (FiscalPeriod{Year{2019}, 1, 1, 1}));
+    EXPECT_EQ(calendar.lookup(Date{Year{2019}, Month{1}, Day{8}}),
+              (FiscalPeriod{Year{2019}, 1, 1, 2}));
+}
+
+TEST(FiscalCalendar, retail_454_with_saturday_nearest_end_of_january)
+{
+    const auto calendar = make_retail_calendar(RetailPattern::P454,
+                                               Month{1},
+                                               Weekday::Saturday,
+                                               YearEnd::NearestWeekday,
+                                               Year{2017},
+                                               Year{2019});
+
+    // 53-week year: the extra week extends the last period
+    EXPECT_EQ(calendar.year_range(Year{2018}),
+              (DateRange{Date{Year{2017}, Month{1}, Day{29}},
+                         Date{Year{2018}, Month{2}, Day{3}}}));
+    EXPECT_EQ(calendar.period_range(Year{2018}, 1),
+              (DateRange{Date{Year{2017}, Month{1}, Day{29}},
+                         Date{Year{2017}, Month{2}, Day{25}}}));
+    EXPECT_EQ(calendar.period_range(Year{2018}, 12),
+              (DateRange{Date{Year{2017}, Month{12}, Day{31}},
+                         Date{Year{2018}, Month{2}, Day{3}}}));
+    EXPECT_EQ(calendar.quarter_range(Year{2018}, 4),
+              (DateRange{Date{Year{2017}, Month{10}, Day{29}},
+                         Date{Year{2018}, Month{2}, Day{3}}}));
+    EXPECT_EQ(calendar.lookup(Date{Year{2018}, Month{2}, Day{3}}),
+              (FiscalPeriod{Year{2018}, 4, 12, 53}));
+    EXPECT_EQ(calendar.lookup(Date{Year{2018}, Month{2}, Day{4}}),
+              (FiscalPeriod{Year{2019}, 1, 1, 1}));
+    EXPECT_EQ(calendar.year_range(Year{2019}).duration(), Days{363});
+}
+
+TEST(FiscalCalendar, retail_445_with_last_saturday_of_august)
+{
+    const auto calendar = make_retail_calendar(RetailPattern::P445,
+                                               Month{8},
+                                               Weekday::Saturday,
+                                               YearEnd::LastWeekday,
+                                               Year{2019},
+                                               Year{2019});
+
+    EXPECT_EQ(calendar.range(),
+              (DateRange{Date{Year{2018}, Month{8}, Day{26}},
+                         Date{Year{2019}, Month{8}, Day{31}}}));
+    EXPECT_EQ(calendar.period_range(Year{2019}, 3),
+              (DateRange{Date{Year{2018}, Month{10}, Day{21}},
+                         Date{Year{2018}, Month{11}, Day{24}}}));
+    EXPECT_EQ(calendar.week_range(Year{2019}, 53),
+              (DateRange{Date{Year{2019}, Month{8}, Day{25}},
+                         Date{Year{2019}, Month{8}, Day{31}}}));
+}
+
+TEST(FiscalCalendar, looks_up_span_of_dates)
+{
+    const auto calendar
+        = make_monthly_calendar(Month{7}, Year{2020}, Year{2020});
+    const std::vector<Date> dates{Date{Year{2019}, Month{7}, Day{1}},
+                                  Date{Year{2019}, Month{10}, Day{1}},
+                                  Date{Year{2020}, Month{6}, Day{30}}};
+    std::vector<FiscalPeriod> periods(dates.size());
+
+    calendar.lookup(dates, periods);
+
+    EXPECT_EQ(periods[0], (FiscalPeriod{Year{2020}, 1, 1, 1}));
+    EXPECT_EQ(periods[1], (FiscalPeriod{Year{2020}, 2, 4, 14}));
+    EXPECT_EQ(periods[2], (FiscalPeriod{Year{2020}, 4, 12, 53}));
+    std::vector<FiscalPeriod> short_periods(1);
+    EXPECT_THROW(calendar.lookup(dates, short_periods), std::invalid_argument);
+}
+
+TEST(FiscalCalendar, rejects_out_of_range_queries)
+{
+    const auto calendar
+        = make_monthly_calendar(Month{4}, Year{2020}, Year{2020});
+
+    EXPECT_THROW(calendar.lookup(Date{Year{2019}, Month{3}, Day{31}}),
+                 std::out_of_range);
+    EXPECT_THROW(calendar.lookup(Date{Year{2020}, Month{4}, Day{1}}),
+                 std::out_of_range);
+    EXPECT_THROW(calendar.year_range(Year{2021}), std::out_of_range);
+    EXPECT_THROW(calendar.quarter_range(Year{2020}, 5), std::out_of_range);
+    EXPECT_THROW(calendar.period_range(Year{2020}, 0), std::out_of_range);
+    EXPECT_THROW(calendar.week_range(Year{2020}, 54), std::out_of_range);
+    EXPECT_THROW(make_monthly_calendar(Month{4}, Year{2020}, Year{2019}),
+                 std::invalid_argument);
+    const std::vector<Date> starts{Date{Year{2020}, Month{1}, Day{1}}};
+    EXPECT_THROW((FiscalCalendar{Year{2020}, starts}), std::invalid_argument);
+}
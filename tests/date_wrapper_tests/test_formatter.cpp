@@ -0,0 +1,83 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/formatter.h>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+TEST(Formatter, compiles_spec_at_compile_time)
+{
+    constexpr auto spec = []() {
+        utils::FormatSpec result;
+        result.compile("yyyy-MM-dd", FormatKind::Date);
+        return result;
+    }();
+
+    static_assert(!spec.empty());
+}
+
+#ifdef DATE_WRAPPER_HAS_FMT
+
+TEST(Formatter, formats_with_fmt)
+{
+    const auto dt
+        = DateTime{Date{Year{2019}, Month{5}, Day{10}}} + 9h + 7min + 5s;
+    const DateRange date_range{Date{Year{2019}, Month{5}, Day{10}},
+                               Date{Year{2019}, Month{5}, Day{12}}};
+
+    EXPECT_EQ("10.05.2019", fmt::format("{}", dt.date()));
+    EXPECT_EQ("2019/05/10", fmt::format("{:yyyy/MM/dd}", dt.date()));
+    EXPECT_EQ("10.05.2019 09:07:05", fmt::format("{}", dt));
+    EXPECT_EQ("at 9:07 AM", fmt::format("{:'at' h:mm AP}", dt));
+    EXPECT_EQ("2019-W19-5", fmt::format("{}", IsoDate{dt.date()}));
+    EXPECT_EQ("10.05 - 12.05", fmt::format("{:dd.MM}", date_range));
+    EXPECT_EQ("[09:07 - 10:07]",
+              fmt::format("[{:hh:mm}]", DateTimeRange{dt, dt + 1h}));
+}
+
+TEST(Formatter, rejects_invalid_spec_with_fmt)
+{
+    const IsoDate iso_date{Date{Year{2019}, Month{5}, Day{10}}};
+
+    EXPECT_THROW(
+        static_cast<void>(fmt::format(fmt::runtime("{:yyyy}"), iso_date)),
+        fmt::format_error);
+}
+
+#endif
+
+#ifdef __cpp_lib_format
+
+TEST(Formatter, formats_with_std_format)
+{
+    const auto dt
+        = DateTime{Date{Year{2019}, Month{5}, Day{10}}} + 9h + 7min + 5s;
+
+    EXPECT_EQ("10.05.2019", std::format("{}", dt.date()));
+    EXPECT_EQ("2019-05-10T09:07:05.000",
+              std::format("{:yyyy-MM-dd'T'hh:mm:ss.zzz}", dt));
+    EXPECT_EQ("DateTimeRange {10.05.2019 09:07:05, 10.05.2019 10:07:05}",
+              std::format("{}", DateTimeRange{dt, dt + 1h}));
+}
+
+#endif
@@ -0,0 +1,128 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/histogram.h>
+
+#include <numeric>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+TEST(CalendarHistogram, counts_events_per_day)
+{
+    const DateRange range{Date{Year{2019}, Month{5}, Day{1}},
+                          Date{Year{2019}, Month{5}, Day{3}}};
+    const DateTime first{Date{Year{2019}, Month{5}, Day{1}}};
+    const std::vector<DateTime> events{
+        first, first + 23h, first + 24h, first + 71h, first + 72h};
+
+    const auto histogram = make_histogram(events, range, BucketUnit::Day);
+
+    EXPECT_EQ(3u, histogram.size());
+    EXPECT_EQ((std::vector<double>{2, 1, 1}), histogram.values());
+    EXPECT_EQ(1u, histogram.dropped());
+}
+
+TEST(CalendarHistogram, sums_weights_per_month)
+{
+    const DateRange range{Date{Year{2018}, Month{12}, Day{15}},
+                          Date{Year{2019}, Month{2}, Day{10}}};
+    const std::vector<DateTime> events{
+        DateTime{Date{Year{2018}, Month{12}, Day{31}}},
+        DateTime{Date{Year{2019}, Month{1}, Day{1}}},
+        DateTime{Date{Year{2019}, Month{1}, Day{31}}},
+        DateTime{Date{Year{2019}, Month{2}, Day{11}}}};
+    const std::vector<double> weights{1.5, 2, 3, 100};
+
+    const auto histogram
+        = make_histogram(events, weights, range, BucketUnit::Month);
+
+    EXPECT_EQ((std::vector<double>{1.5, 5, 0}), histogram.values());
+    EXPECT_EQ(1u, histogram.dropped());
+    EXPECT_EQ((DateRange{Date{Year{2019}, Month{2}, Day{1}},
+                         Date{Year{2019}, Month{2}, Day{28}}}),
+              histogram.bucket(2));
+}
+
+TEST(CalendarHistogram, month_buckets_match_calendar_months)
+{
+    const DateRange range{Date{Year{1899}, Month{3}, Day{17}},
+                          Date{Year{2301}, Month{1}, Day{5}}};
+    const CalendarHistogram histogram{range, BucketUnit::Month};
+
+    for (Date date = range.start(); date <= range.finish();
+         date = date + Days{1}) {
+        const Date first{date.year(), date.month(), Day{1}};
+        ASSERT_EQ(histogram.bucket(histogram.bucket_index(date)).start(),
+                  first);
+    }
+}
+
+TEST(CalendarHistogram, buckets_by_iso_week_across_year_boundary)
+{
+    const DateRange range{Date{Year{2018}, Month{12}, Day{29}},
+                          Date{Year{2019}, Month{1}, Day{7}}};
+    CalendarHistogram histogram{range, BucketUnit::IsoWeek};
+
+    histogram.add(DateTime{Date{Year{2018}, Month{12}, Day{30}}});
+    histogram.add(DateTime{Date{Year{2018}, Month{12}, Day{31}}});
+    histogram.add(DateTime{Date{Year{2019}, Month{1}, Day{6}}});
+    histogram.add(DateTime{Date{Year{2019}, Month{1}, Day{7}}});
+
+    EXPECT_EQ((std::vector<double>{1, 2, 1}), histogram.values());
+    EXPECT_EQ((DateRange{Date{Year{2018}, Month{12}, Day{31}},
+                         Date{Year{2019}, Month{1}, Day{6}}}),
+              histogram.bucket(1));
+}
+
+TEST(CalendarHistogram, parallel_result_matches_sequential)
+{
+    const DateRange range{Date{Year{2019}, Month{1}, Day{1}},
+                          Date{Year{2019}, Month{12}, Day{31}}};
+    const DateTime start{range.start()};
+    std::vector<DateTime> events;
+    for (int i = 0; i < 100'000; ++i)
+        events.push_back(start + std::chrono::minutes{i * 7});
+
+    const auto sequential
+        = make_histogram(events, range, BucketUnit::Day, 1);
+    const auto parallel = make_histogram(events, range, BucketUnit::Day, 8);
+
+    EXPECT_EQ(sequential.values(), parallel.values());
+    EXPECT_EQ(sequential.dropped(), parallel.dropped());
+    EXPECT_EQ(static_cast<double>(events.size()),
+              std::accumulate(parallel.values().cbegin(),
+                              parallel.values().cend(),
+                              static_cast<double>(parallel.dropped())));
+}
+
+TEST(CalendarHistogram, throws_when_weights_size_differs)
+{
+    const DateRange range{Date{Year{2019}, Month{1}, Day{1}},
+                          Date{Year{2019}, Month{1}, Day{2}}};
+    const std::vector<DateTime> events{DateTime{range.start()}};
+    const std::vector<double> weights;
+
+    EXPECT_THROW(make_histogram(events, weights, range, BucketUnit::Day),
+                 std::invalid_argument);
+}
@@ -0,0 +1,77 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/date_wrapper.h>
+
+#include <thread>
+
+using namespace dw;
+using dw::instrumentation::Counter;
+
+TEST(Instrumentation, counts_calls_of_entry_points)
+{
+    instrumentation::reset();
+    const Date date{Year{2019}, Month{1}, Day{31}};
+
+    const auto formatted = to_string(date, "dd.MM.yyyy");
+    const auto clamped = date + Months{1};
+    const auto normalized = normalize(Date{Year{2019}, Month{13}, Day{1}});
+    const auto snapshot = instrumentation::snapshot();
+
+    EXPECT_EQ("31.01.2019", formatted);
+    EXPECT_EQ((Date{Year{2019}, Month{2}, Day{28}}), clamped);
+    EXPECT_EQ((Date{Year{2020}, Month{1}, Day{1}}), normalized);
+    const std::uint64_t expected = instrumentation::enabled ? 1 : 0;
+    EXPECT_EQ(expected, snapshot.count(Counter::ToStringDate));
+    EXPECT_EQ(expected, snapshot.count(Counter::MonthClamp));
+    EXPECT_EQ(expected, snapshot.count(Counter::Normalize));
+    EXPECT_EQ(0u, snapshot.count(Counter::YearClamp));
+}
+
+TEST(Instrumentation, does_not_count_compile_time_evaluation)
+{
+    instrumentation::reset();
+
+    constexpr Date clamped{Date{Year{2019}, Month{1}, Day{31}} + Months{1}};
+
+    static_assert(clamped == Date{Year{2019}, Month{2}, Day{28}});
+    EXPECT_EQ(0u, instrumentation::snapshot().count(Counter::MonthClamp));
+}
+
+TEST(Instrumentation, keeps_counters_of_finished_threads)
+{
+    instrumentation::reset();
+    const DateTime dt{Date{Year{2019}, Month{5}, Day{10}}};
+
+    std::thread worker{[&dt]() {
+        for (unsigned i = 0; i < instrumentation::sampling_period; ++i)
+            to_string(dt, "hh:mm");
+    }};
+    worker.join();
+    const auto snapshot = instrumentation::snapshot();
+
+    const std::uint64_t expected
+        = instrumentation::enabled ? instrumentation::sampling_period : 0;
+    EXPECT_EQ(expected, snapshot.count(Counter::ToStringDateTime));
+    EXPECT_EQ(instrumentation::enabled ? 1u : 0u,
+              snapshot.latency(Counter::ToStringDateTime).samples);
+}
@@ -22,7 +22,10 @@
 #include "gtest/gtest.h"
 #include <date_wrapper/date_wrapper.h>
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
+#include <vector>
 
 using namespace dw;
 
@@ -73,3 +76,99 @@ TEST(IsoDate, test_iso_weekday)
     static_assert(Weekday::Monday
                   == IsoDate{Date{Year{2017}, Month{1}, Day{2}}}.weekday());
 }
+
+TEST(IsoDate, is_regular_and_ordered)
+{
+    static_assert(sizeof(IsoDate) == 4);
+    static_assert(IsoDate{} == IsoDate{Date{Year{1970}, Month{1}, Day{1}}});
+    static_assert(IsoDate{Date{Year{2015}, Month{12}, Day{31}}}
+                  < IsoDate{Date{Year{2016}, Month{1}, Day{3}}});
+    static_assert(IsoDate{Date{Year{2016}, Month{1}, Day{4}}}
+                  > IsoDate{Date{Year{2016}, Month{1}, Day{3}}});
+
+    std::vector<IsoDate> dates{IsoDate{Date{Year{2019}, Month{5}, Day{10}}},
+                               IsoDate{Date{Year{2018}, Month{5}, Day{10}}}};
+    dates.push_back(dates.front());
+    std::sort(dates.begin(), dates.end());
+    EXPECT_EQ(Year{2018}, dates.front().year());
+
+    const std::unordered_set<IsoDate> unique(dates.begin(), dates.end());
+    EXPECT_EQ(2u, unique.size());
+}
+
+TEST(IsoDate, round_trips_through_calendar_date)
+{
+    constexpr IsoDate iso_date{Year{2020}, 53, Weekday::Friday};
+
+    static_assert(iso_date.date() == Date{Year{2021}, Month{1}, Day{1}});
+    static_assert(IsoDate{iso_date.date()} == iso_date);
+    static_assert(202053 == iso_date.week_key());
+    static_assert(IsoDate::from_serial_day(-1)
+                  == IsoDate{Date{Year{1969}, Month{12}, Day{31}}});
+    static_assert(IsoDate::from_packed(iso_date.packed()) == iso_date);
+
+    const Date start{Year{1999}, Month{12}, Day{1}};
+    for (long long day = 0; day < 800; ++day) {
+        const Date date{start + Days{day}};
+        EXPECT_EQ(date, IsoDate{date}.date());
+    }
+}
+
+TEST(IsoDate, converts_dates_in_batches)
+{
+    const std::vector<Date> dates{Date{Year{2018}, Month{12}, Day{30}},
+                                  Date{Year{2018}, Month{12}, Day{31}},
+                                  Date{Year{2019}, Month{1}, Day{6}},
+                                  Date{Year{2019}, Month{1}, Day{7}},
+                                  Date{Year{2019}, Month{1}, Day{2}}};
+    std::vector<std::int32_t> keys(dates.size());
+    std::vector<IsoDate> iso_dates(dates.size());
+
+    to_iso_week_keys(dates, keys);
+    to_iso_dates(dates, iso_dates);
+
+    const std::vector<std::int32_t> expected{
+        201852, 201901, 201901, 201902, 201901};
+    EXPECT_EQ(expected, keys);
+    for (std::size_t i = 0; i < dates.size(); ++i)
+        EXPECT_EQ(IsoDate{dates[i]}, iso_dates[i]);
+    EXPECT_THROW(to_iso_dates(dates, span<IsoDate>{}), std::invalid_argument);
+}
+
+TEST(IsoDate, builds_week_and_year_ranges)
+{
+    static_assert(53 == iso_weeks_in_year(Year{2020}));
+    static_assert(52 == iso_weeks_in_year(Year{2021}));
+    static_assert(53 == iso_weeks_in_year(Year{2015}));
+    static_assert(iso_week_range(Year{2020}, 53)
+                  == DateRange{Date{Year{2020}, Month{12}, Day{28}},
+                               Date{Year{2021}, Month{1}, Day{3}}});
+    static_assert(iso_week_range(IsoDate{Date{Year{2019}, Month{5}, Day{10}}})
+                  == DateRange{Date{Year{2019}, Month{5}, Day{6}},
+                               Date{Year{2019}, Month{5}, Day{12}}});
+    static_assert(iso_year_range(Year{2016})
+                  == DateRange{Date{Year{2016}, Month{1}, Day{4}},
+                               Date{Year{2017}, Month{1}, Day{1}}});
+}
+
+TEST(IsoDate, iterates_weeks_intersecting_range)
+{
+    const DateRange range{Date{Year{2020}, Month{12}, Day{20}},
+                          Date{Year{2021}, Month{1}, Day{11}}};
+    std::vector<std::int32_t> keys;
+
+    for (const IsoDate& monday : iso_weeks(range))
+        keys.push_back(monday.week_key());
+
+    EXPECT_EQ((std::vector<std::int32_t>{202051, 202052, 202053, 202101,
+                                         202102}),
+              keys);
+    EXPECT_EQ(keys.size(), iso_weeks(range).size());
+    EXPECT_EQ(Weekday::Monday, iso_weeks(range).begin()->weekday());
+
+    const DateRange one_day{Date{Year{2021}, Month{1}, Day{3}},
+                            Date{Year{2021}, Month{1}, Day{3}}};
+    EXPECT_EQ(1u, iso_weeks(one_day).size());
+    EXPECT_EQ(1, std::distance(iso_weeks(one_day).begin(),
+                               iso_weeks(one_day).end()));
+}
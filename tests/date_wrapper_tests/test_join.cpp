@@ -0,0 +1,100 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/join.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<DateTimeRange> random_ranges(std::size_t count, unsigned seed)
+{
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<int> minute{0, 24 * 60};
+    std::uniform_int_distribution<int> length{-90, 90};
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    std::vector<DateTimeRange> ranges;
+    for (std::size_t i = 0; i < count; ++i) {
+        const DateTime first{start + std::chrono::minutes{minute(gen)}};
+        ranges.emplace_back(first, first + std::chrono::minutes{length(gen)});
+    }
+    return ranges;
+}
+
+} // namespace
+
+TEST(OverlapJoin, matches_nested_loops)
+{
+    const auto sessions = random_ranges(500, 1);
+    const auto windows = random_ranges(300, 2);
+
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t i = 0; i < sessions.size(); ++i) {
+        for (std::size_t j = 0; j < windows.size(); ++j) {
+            if (overlaps(sessions[i], windows[j]))
+                expected.emplace_back(i, j);
+        }
+    }
+    auto pairs = overlap_join(sessions, windows);
+    std::sort(pairs.begin(), pairs.end());
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST(OverlapJoin, skips_touching_and_empty_ranges)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    const std::vector<DateTimeRange> left{{start, start + 1h},
+                                          {start + 2h, start + 2h}};
+    const std::vector<DateTimeRange> right{{start + 1h, start + 3h},
+                                           {start + 30min, start}};
+
+    const auto pairs = overlap_join(left, right);
+
+    ASSERT_EQ(pairs.size(), 1u);
+    EXPECT_EQ(pairs[0], (std::pair<std::size_t, std::size_t>{0, 1}));
+}
+
+TEST(OverlapJoin, joins_ranges_outside_nanosecond_key_range)
+{
+    // Nanoseconds since epoch overflow int64 on 2262-04-11
+    const DateTime month{Date{Year{2262}, Month{4}, Day{1}}};
+    const DateTime early{Date{Year{1500}, Month{1}, Day{1}}};
+    const std::vector<DateTimeRange> left{{month, month + Days{30}},
+                                          {early, early + 48h}};
+    const std::vector<DateTimeRange> right{{month + Days{19}, month + Days{20}},
+                                           {early + 24h, early + 72h}};
+
+    auto pairs = overlap_join(left, right);
+    std::sort(pairs.begin(), pairs.end());
+
+    const std::vector<std::pair<std::size_t, std::size_t>> expected{{0, 0},
+                                                                    {1, 1}};
+    EXPECT_EQ(pairs, expected);
+}
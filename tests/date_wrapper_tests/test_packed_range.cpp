@@ -0,0 +1,130 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/packed_range.h>
+
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+static_assert(sizeof(PackedDateTimeRange) == 8,
+              "PackedDateTimeRange must take 8 bytes");
+
+namespace {
+
+const DateTime may1{Date{Year{2019}, Month{5}, Day{1}}};
+
+} // namespace
+
+TEST(PackedDateTimeRange, round_trips_representable_ranges)
+{
+    const DateTimeRange range{may1 + 90s, may1 + 2h};
+
+    const PackedDateTimeRange packed{range};
+
+    EXPECT_EQ(1556668890u, packed.start_seconds());
+    EXPECT_EQ(7110u, packed.length_seconds());
+    EXPECT_EQ(range, packed.to_range());
+    EXPECT_EQ(may1 + 2h, packed.finish());
+    EXPECT_EQ(7110s, packed.duration());
+}
+
+TEST(PackedDateTimeRange, covers_documented_limits)
+{
+    const DateTime epoch{Date{Year{1970}, Month{1}, Day{1}}};
+    const DateTime last_start{Date{Year{2106}, Month{2}, Day{7}},
+                              6h + 28min + 15s};
+
+    EXPECT_TRUE(PackedDateTimeRange::representable(
+        DateTimeRange{epoch, epoch + 4294967295s}));
+    EXPECT_TRUE(PackedDateTimeRange::representable(
+        DateTimeRange{last_start, last_start}));
+    EXPECT_FALSE(PackedDateTimeRange::representable(
+        DateTimeRange{last_start + 1s, last_start + 1s}));
+    EXPECT_FALSE(PackedDateTimeRange::representable(
+        DateTimeRange{epoch - 1s, epoch}));
+    EXPECT_FALSE(PackedDateTimeRange::representable(
+        DateTimeRange{epoch, epoch + 4294967296s}));
+    EXPECT_FALSE(PackedDateTimeRange::representable(
+        DateTimeRange{may1, may1 + 1500ms}));
+    EXPECT_FALSE(
+        PackedDateTimeRange::representable(DateTimeRange{may1 + 1s, may1}));
+    EXPECT_THROW(PackedDateTimeRange{(DateTimeRange{may1 + 1s, may1})},
+                 std::out_of_range);
+}
+
+TEST(PackedDateTimeRange, contains_is_half_open)
+{
+    const PackedDateTimeRange packed{DateTimeRange{may1, may1 + 1min}};
+
+    EXPECT_TRUE(contains(packed, may1));
+    EXPECT_TRUE(contains(packed, may1 + 59s + 999ms));
+    EXPECT_FALSE(contains(packed, may1 + 1min));
+    EXPECT_FALSE(contains(packed, may1 - 1ms));
+    EXPECT_FALSE(contains(PackedDateTimeRange{0, 10},
+                          DateTime{Date{Year{1960}, Month{1}, Day{1}}}));
+}
+
+TEST(PackedDateTimeRange, overlaps_matches_date_time_range)
+{
+    const std::vector<DateTimeRange> ranges{
+        DateTimeRange{may1, may1 + 1h},
+        DateTimeRange{may1 + 1h, may1 + 2h},
+        DateTimeRange{may1 + 30min, may1 + 30min},
+        DateTimeRange{may1 - 1h, may1 + 3h}};
+    for (const auto& lhs : ranges) {
+        for (const auto& rhs : ranges) {
+            EXPECT_EQ(overlaps(lhs, rhs),
+                      overlaps(PackedDateTimeRange{lhs},
+                               PackedDateTimeRange{rhs}));
+        }
+    }
+}
+
+TEST(PackedDateTimeRange, checks_arrays_of_ranges)
+{
+    std::vector<PackedDateTimeRange> packed;
+    for (int i = 0; i < 100; ++i) {
+        const DateTime start{may1 + std::chrono::minutes{i}};
+        packed.emplace_back(DateTimeRange{start, start + 3min});
+    }
+    std::vector<std::uint8_t> flags(packed.size());
+
+    contains(packed, may1 + 5min, flags);
+
+    EXPECT_EQ(0u, flags[2]);
+    EXPECT_EQ(1u, flags[3]);
+    EXPECT_EQ(1u, flags[5]);
+    EXPECT_EQ(0u, flags[6]);
+    EXPECT_EQ(3u, count_containing(packed, may1 + 5min));
+
+    const PackedDateTimeRange probe{DateTimeRange{may1 + 8min, may1 + 9min}};
+    overlaps(packed, probe, flags);
+    EXPECT_EQ(1u, flags[8]);
+    EXPECT_EQ(0u, flags[9]);
+    EXPECT_EQ(0u, flags[5]);
+    EXPECT_EQ(3u, count_overlapping(packed, probe));
+
+    std::vector<std::uint8_t> short_flags(1);
+    EXPECT_THROW(contains(packed, may1, short_flags), std::invalid_argument);
+}
@@ -0,0 +1,235 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/parallel.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+TEST(Split, splits_date_range_into_nearly_equal_parts)
+{
+    const DateRange range{Date{Year{2019}, Month{5}, Day{1}},
+                          Date{Year{2019}, Month{5}, Day{10}}};
+
+    const auto parts = split(range, 3);
+
+    ASSERT_EQ(3u, parts.size());
+    EXPECT_EQ((DateRange{Date{Year{2019}, Month{5}, Day{1}},
+                         Date{Year{2019}, Month{5}, Day{4}}}),
+              parts[0]);
+    EXPECT_EQ((DateRange{Date{Year{2019}, Month{5}, Day{8}},
+                         Date{Year{2019}, Month{5}, Day{10}}}),
+              parts[2]);
+    EXPECT_EQ(10u, split(range, 20).size());
+    EXPECT_THROW(split(range, 0), std::invalid_argument);
+}
+
+TEST(Split, splits_date_time_range_without_gaps)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    const DateTimeRange range{start, start + 10h};
+
+    const auto parts = split(range, 3);
+
+    ASSERT_EQ(3u, parts.size());
+    EXPECT_EQ(start, parts.front().start());
+    EXPECT_EQ(start + 10h, parts.back().finish());
+    EXPECT_EQ(parts[0].finish(), parts[1].start());
+    EXPECT_EQ(parts[1].finish(), parts[2].start());
+}
+
+TEST(Split, splits_by_calendar_units)
+{
+    const DateRange range{Date{Year{2019}, Month{1}, Day{30}},
+                          Date{Year{2019}, Month{3}, Day{2}}};
+
+    const auto months = split_by(range, BucketUnit::Month);
+    const auto weeks = split_by(range, BucketUnit::IsoWeek);
+
+    ASSERT_EQ(3u, months.size());
+    EXPECT_EQ((DateRange{Date{Year{2019}, Month{2}, Day{1}},
+                         Date{Year{2019}, Month{2}, Day{28}}}),
+              months[1]);
+    EXPECT_EQ((DateRange{Date{Year{2019}, Month{3}, Day{1}},
+                         Date{Year{2019}, Month{3}, Day{2}}}),
+              months[2]);
+    ASSERT_EQ(5u, weeks.size());
+    EXPECT_EQ((DateRange{Date{Year{2019}, Month{1}, Day{30}},
+                         Date{Year{2019}, Month{2}, Day{3}}}),
+              weeks[0]);
+    EXPECT_EQ(32u, split_by(range, BucketUnit::Day).size());
+}
+
+TEST(Split, splits_date_time_range_at_midnights)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    const DateTimeRange range{start + 22h, start + 50h};
+
+    const auto days = split_by(range, BucketUnit::Day);
+
+    ASSERT_EQ(3u, days.size());
+    EXPECT_EQ((DateTimeRange{start + 22h, start + 24h}), days[0]);
+    EXPECT_EQ((DateTimeRange{start + 24h, start + 48h}), days[1]);
+    EXPECT_EQ((DateTimeRange{start + 48h, start + 50h}), days[2]);
+}
+
+TEST(ParallelForEach, visits_every_step_once)
+{
+    const Date start{Year{2019}, Month{1}, Day{1}};
+    const DateRange range{start, Date{Year{2019}, Month{12}, Day{31}}};
+    std::vector<std::atomic<int>> visits(365);
+
+    parallel_for_each(
+        range,
+        Days{1},
+        [&](const Date& date) {
+            // Month-end spike makes shares uneven
+            if (date == last_day_of_month(date))
+                std::this_thread::sleep_for(1ms);
+            ++visits[static_cast<std::size_t>(
+                DateRange{start, date}.duration().count())];
+        },
+        4);
+
+    for (const auto& count : visits)
+        EXPECT_EQ(1, count.load());
+}
+
+TEST(ParallelForEach, steps_over_date_time_range)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    std::atomic<int> calls{0};
+
+    parallel_for_each(
+        DateTimeRange{start, start + 24h},
+        6h,
+        [&](const DateTime&) { ++calls; },
+        2);
+
+    EXPECT_EQ(5, calls.load());
+    EXPECT_THROW(parallel_for_each(
+                     DateTimeRange{start, start}, 0h, [](const DateTime&) {}),
+                 std::invalid_argument);
+}
+
+TEST(ParallelForEach, rethrows_first_exception)
+{
+    const DateRange range{Date{Year{2019}, Month{1}, Day{1}},
+                          Date{Year{2019}, Month{1}, Day{31}}};
+
+    EXPECT_THROW(parallel_for_each(
+                     range,
+                     Days{1},
+                     [](const Date& date) {
+                         if (date.day() == Day{15})
+                             throw std::runtime_error("failed");
+                     },
+                     3),
+                 std::runtime_error);
+}
+
+TEST(ForEachChunk, rethrows_worker_exception_after_join)
+{
+    std::atomic<std::size_t> visited{0};
+
+    EXPECT_THROW(utils::for_each_chunk(
+                     std::size_t{4096 * 4},
+                     4,
+                     [&visited](std::size_t chunk, std::size_t, std::size_t) {
+                         if (chunk == 2)
+                             throw std::runtime_error("failed");
+                         ++visited;
+                     }),
+                 std::runtime_error);
+    EXPECT_EQ(3u, visited.load());
+}
+
+TEST(Generate, fills_day_series_up_to_finish)
+{
+    const DateRange range{Date{Year{2019}, Month{12}, Day{30}},
+                          Date{Year{2020}, Month{1}, Day{6}}};
+    std::vector<Date> out(10, range.start());
+
+    EXPECT_EQ(3u, series_size(range, Days{3}));
+    ASSERT_EQ(3u, generate(range, Days{3}, out));
+    EXPECT_EQ(Date(Year{2019}, Month{12}, Day{30}), out[0]);
+    EXPECT_EQ(Date(Year{2020}, Month{1}, Day{2}), out[1]);
+    EXPECT_EQ(Date(Year{2020}, Month{1}, Day{5}), out[2]);
+    EXPECT_THROW(generate(range, Days{0}, out), std::invalid_argument);
+}
+
+TEST(Generate, matches_repeated_addition_across_threads)
+{
+    const DateTime start{Date{Year{2019}, Month{12}, Day{31}}, 23h + 59min};
+    const DateTimeRange range{start, start + 24h * 30};
+    const std::size_t size = series_size(range, 1min);
+    std::vector<DateTime> out(size, start);
+
+    ASSERT_EQ(30u * 24 * 60 + 1, size);
+    ASSERT_EQ(size, generate(range, 1min, out, 4));
+    DateTime expected{start};
+    for (std::size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(expected, out[i]) << i;
+        expected = expected + 1min;
+    }
+}
+
+TEST(Generate, stops_at_end_of_output)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    std::vector<DateTime> out(2, start);
+
+    EXPECT_EQ(2u, generate(DateTimeRange{start, start + 10h}, 1h, out));
+    EXPECT_EQ(start + 1h, out[1]);
+}
+
+TEST(Generate, month_steps_clamp_each_value_from_start)
+{
+    const DateRange range{Date{Year{2019}, Month{1}, Day{31}},
+                          Date{Year{2019}, Month{4}, Day{30}}};
+    std::vector<Date> out(4, range.start());
+
+    ASSERT_EQ(4u, generate(range, Months{1}, out));
+    EXPECT_EQ(Date(Year{2019}, Month{2}, Day{28}), out[1]);
+    EXPECT_EQ(Date(Year{2019}, Month{3}, Day{31}), out[2]);
+    EXPECT_EQ(Date(Year{2019}, Month{4}, Day{30}), out[3]);
+    EXPECT_EQ(3u,
+              series_size(DateRange{range.start(),
+                                    Date{Year{2019}, Month{4}, Day{29}}},
+                          Months{1}));
+    EXPECT_THROW(series_size(range, Months{0}), std::invalid_argument);
+}
+
+TEST(Generate, month_steps_keep_time_of_day)
+{
+    const DateTime start{Date{Year{2019}, Month{8}, Day{31}}, 12h};
+    const DateTimeRange range{start,
+                              DateTime{Date{Year{2020}, Month{2}, Day{29}}}};
+    std::vector<DateTime> out(3, start);
+
+    ASSERT_EQ(2u, generate(range, Months{3}, out));
+    EXPECT_EQ((DateTime{Date{Year{2019}, Month{11}, Day{30}}, 12h}), out[1]);
+}
@@ -0,0 +1,103 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/relative.h>
+
+#include <vector>
+
+using namespace dw;
+
+TEST(RelativeDate, evaluates_business_rules)
+{
+    const Date date{Year{2019}, Month{5}, Day{10}};
+
+    const auto next_month = RelativeDate{}.plus(Months{1}).start_of(
+        CalendarPeriod::Month);
+    const auto last_friday
+        = RelativeDate{}.nth_weekday(-1, Weekday::Friday);
+    const auto third_monday
+        = RelativeDate{}.nth_weekday(3, Weekday::Monday);
+    const auto quarter_end = RelativeDate{}
+                                 .end_of(CalendarPeriod::Quarter)
+                                 .plus(Days{-2});
+
+    EXPECT_EQ((Date{Year{2019}, Month{6}, Day{1}}), next_month(date));
+    EXPECT_EQ((Date{Year{2019}, Month{5}, Day{31}}), last_friday(date));
+    EXPECT_EQ((Date{Year{2019}, Month{5}, Day{20}}), third_monday(date));
+    EXPECT_EQ((Date{Year{2019}, Month{6}, Day{28}}), quarter_end(date));
+}
+
+TEST(RelativeDate, matches_free_functions)
+{
+    const auto rule = RelativeDate{}
+                          .plus(Months{1})
+                          .next(Weekday::Friday)
+                          .plus(Years{1})
+                          .prev_or_same(Weekday::Sunday);
+    const auto month_end = RelativeDate{}.end_of(CalendarPeriod::Month);
+    const Date start{Year{1999}, Month{12}, Day{25}};
+
+    for (int i = 0; i < 800; ++i) {
+        const Date date{start + Days{i}};
+        const Date expected{prev_weekday(
+            next_weekday_excluding_current(date + Months{1},
+                                           Weekday::Friday)
+                + Years{1},
+            Weekday::Sunday)};
+        EXPECT_EQ(expected, rule(date));
+        EXPECT_EQ(last_day_of_month(date), month_end(date));
+    }
+}
+
+TEST(RelativeDate, moves_to_period_boundaries)
+{
+    const Date date{Year{2020}, Month{2}, Day{29}};
+
+    EXPECT_EQ((Date{Year{2020}, Month{2}, Day{24}}),
+              RelativeDate{}.start_of(CalendarPeriod::IsoWeek)(date));
+    EXPECT_EQ((Date{Year{2020}, Month{3}, Day{1}}),
+              RelativeDate{}.end_of(CalendarPeriod::IsoWeek)(date));
+    EXPECT_EQ((Date{Year{2020}, Month{1}, Day{1}}),
+              RelativeDate{}.start_of(CalendarPeriod::Quarter)(date));
+    EXPECT_EQ((Date{Year{2020}, Month{12}, Day{31}}),
+              RelativeDate{}.end_of(CalendarPeriod::Year)(date));
+    EXPECT_EQ((Date{Year{2021}, Month{2}, Day{28}}),
+              RelativeDate{}.plus(Years{1})(date));
+}
+
+TEST(RelativeDate, merges_day_steps_and_applies_to_spans)
+{
+    const auto rule = RelativeDate{}.plus(Days{3}).plus(Weeks{1}).plus(
+        Days{-1});
+    const std::vector<Date> dates{Date{Year{2019}, Month{12}, Day{30}},
+                                  Date{Year{1969}, Month{12}, Day{31}}};
+    std::vector<Date> results(dates.size(), dates.front());
+
+    rule(dates, results);
+
+    EXPECT_EQ(1u, rule.size());
+    EXPECT_EQ((Date{Year{2020}, Month{1}, Day{8}}), results[0]);
+    EXPECT_EQ((Date{Year{1970}, Month{1}, Day{9}}), results[1]);
+    EXPECT_THROW(rule(dates, span<Date>{}), std::invalid_argument);
+    EXPECT_THROW(RelativeDate{}.nth_weekday(0, Weekday::Monday),
+                 std::invalid_argument);
+}
@@ -0,0 +1,135 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/rle.h>
+
+#include <map>
+#include <vector>
+
+using namespace dw;
+
+namespace {
+
+const Date may1{Year{2019}, Month{5}, Day{1}};
+const Date may2{Year{2019}, Month{5}, Day{2}};
+const Date may3{Year{2019}, Month{5}, Day{3}};
+const Date may4{Year{2019}, Month{5}, Day{4}};
+
+} // namespace
+
+TEST(RleDateColumn, encodes_runs_of_equal_dates)
+{
+    const std::vector<Date> dates{may1, may1, may1, may2, may3, may3};
+
+    const RleDateColumn column{dates};
+
+    EXPECT_EQ(6u, column.size());
+    ASSERT_EQ(3u, column.run_count());
+    EXPECT_TRUE(column.sorted());
+    EXPECT_EQ(may2, column.runs()[1].date);
+    EXPECT_EQ(3u, column.runs()[1].first);
+    EXPECT_EQ(2u, column.runs()[2].count);
+    for (std::size_t i = 0; i < dates.size(); ++i)
+        EXPECT_EQ(dates[i], column[i]) << i;
+    EXPECT_EQ(1u, column.run_index(3));
+    EXPECT_EQ(3u, column.run_index(6));
+    EXPECT_THROW(column.at(6), std::out_of_range);
+}
+
+TEST(RleDateColumn, decodes_to_plain_column)
+{
+    const std::vector<Date> dates{may3, may1, may1, may3, may3, may2};
+    const RleDateColumn column{dates};
+    std::vector<Date> out(dates.size(), may4);
+
+    column.decode(out);
+
+    EXPECT_EQ(dates, out);
+    EXPECT_FALSE(column.sorted());
+    std::vector<Date> short_out(2, may4);
+    EXPECT_THROW(column.decode(short_out), std::invalid_argument);
+}
+
+TEST(RleDateColumn, appends_to_last_run)
+{
+    RleDateColumn column;
+    column.append(may1, 1000);
+    column.push_back(may1);
+    column.append(may2, 0);
+    column.append(may2, 500);
+
+    EXPECT_EQ(1501u, column.size());
+    EXPECT_EQ(2u, column.run_count());
+    EXPECT_EQ(may1, column[1000]);
+    EXPECT_EQ(may2, column[1001]);
+
+    column.clear();
+    EXPECT_TRUE(column.empty());
+    EXPECT_EQ(0u, column.run_count());
+}
+
+TEST(RleDateColumn, filters_sorted_column)
+{
+    RleDateColumn column;
+    column.append(may1, 10);
+    column.append(may2, 20);
+    column.append(may3, 30);
+    column.append(may4, 40);
+
+    EXPECT_EQ(50u, column.count(DateRange{may2, may3}));
+    EXPECT_EQ(std::vector<RowRange>{(RowRange{10, 60})},
+              column.filter(DateRange{may3, may2}));
+    EXPECT_EQ(0u, column.count(DateRange{Date{Year{2019}, Month{6}, Day{1}},
+                                         Date{Year{2019}, Month{6}, Day{2}}}));
+    EXPECT_TRUE(column.filter(DateRange{Date{Year{2019}, Month{4}, Day{1}},
+                                        Date{Year{2019}, Month{4}, Day{30}}})
+                    .empty());
+}
+
+TEST(RleDateColumn, filters_unsorted_column)
+{
+    RleDateColumn column;
+    column.append(may3, 5);
+    column.append(may1, 5);
+    column.append(may2, 5);
+    column.append(may4, 5);
+    column.append(may2, 5);
+
+    const std::vector<RowRange> expected{RowRange{0, 5}, RowRange{10, 15},
+                                         RowRange{20, 25}};
+    EXPECT_EQ(expected, column.filter(DateRange{may2, may3}));
+    EXPECT_EQ(15u, column.count(DateRange{may2, may3}));
+}
+
+TEST(RleDateColumn, aggregates_per_run)
+{
+    const std::vector<Date> dates{may1, may1, may2, may1};
+    const RleDateColumn column{dates};
+    std::map<Date, std::size_t> rows_per_date;
+
+    column.for_each_run([&](const Date& date, std::size_t count) {
+        rows_per_date[date] += count;
+    });
+
+    EXPECT_EQ(3u, rows_per_date[may1]);
+    EXPECT_EQ(1u, rows_per_date[may2]);
+}
@@ -0,0 +1,115 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/search.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+TEST(DateTimeIndex, matches_std_lower_bound)
+{
+    const DateTime start{Date{Year{2019}, Month{1}, Day{1}}};
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> minutes{0, 100000};
+    for (std::size_t size : {0u, 1u, 2u, 7u, 8u, 100u, 1000u}) {
+        std::vector<DateTime> values;
+        for (std::size_t i = 0; i < size; ++i)
+            values.push_back(start + std::chrono::minutes{minutes(gen)});
+        std::sort(values.begin(), values.end());
+        const DateTimeIndex index{values};
+
+        for (int probe = -10; probe < 100010; probe += 997) {
+            const DateTime dt{start + std::chrono::minutes{probe}};
+            const auto expected = static_cast<std::size_t>(
+                std::lower_bound(values.begin(), values.end(), dt)
+                - values.begin());
+            EXPECT_EQ(expected, index.lower_bound(dt));
+        }
+    }
+}
+
+TEST(DateTimeIndex, batch_lookup_matches_single_lookups)
+{
+    const DateTime start{Date{Year{2019}, Month{1}, Day{1}}};
+    std::vector<DateTime> values;
+    for (int i = 0; i < 50; ++i)
+        values.push_back(start + std::chrono::hours{i / 2});
+    const DateTimeIndex index{values};
+    std::vector<DateTime> probes;
+    for (int i = -3; i < 60; ++i)
+        probes.push_back(start + std::chrono::minutes{i * 30});
+    std::vector<std::size_t> positions(probes.size());
+
+    index.lower_bound(probes, positions);
+
+    for (std::size_t i = 0; i < probes.size(); ++i)
+        EXPECT_EQ(index.lower_bound(probes[i]), positions[i]);
+    EXPECT_EQ(0u, positions.front());
+    EXPECT_EQ(values.size(), positions.back());
+    EXPECT_EQ(2u, index.lower_bound(start + 30min));
+}
+
+TEST(DateTimeIndex, rejects_unsorted_input)
+{
+    const DateTime start{Date{Year{2019}, Month{1}, Day{1}}};
+    const std::vector<DateTime> values{start + 1h, start};
+    std::vector<std::size_t> positions(1);
+
+    EXPECT_THROW(DateTimeIndex{values}, std::invalid_argument);
+    EXPECT_THROW(DateTimeIndex{span<const DateTime>{}}.lower_bound(
+                     values, positions),
+                 std::invalid_argument);
+}
+
+TEST(DateTimeIndex, rejects_values_outside_nanosecond_keys)
+{
+    const DateTime start{Date{Year{2261}, Month{12}, Day{31}}};
+    const std::vector<DateTime> values{start, start + 48h};
+
+    EXPECT_THROW(DateTimeIndex{values}, std::out_of_range);
+}
+
+TEST(DateTimeIndex, probes_outside_nanosecond_keys_saturate)
+{
+    const DateTime start{Date{Year{2261}, Month{12}, Day{31}}};
+    const std::vector<DateTime> values{DateTime{Date{Year{1678}, Month{1},
+                                                     Day{1}}},
+                                       start,
+                                       start + 23h};
+    const DateTimeIndex index{values};
+    const std::vector<DateTime> probes{
+        DateTime{Date{Year{1500}, Month{6}, Day{1}}},
+        start + 24h,
+        DateTime{Date{Year{2300}, Month{1}, Day{1}}}};
+    std::vector<std::size_t> positions(probes.size());
+
+    index.lower_bound(probes, positions);
+
+    EXPECT_EQ(0u, positions[0]);
+    EXPECT_EQ(3u, positions[1]);
+    EXPECT_EQ(3u, positions[2]);
+    EXPECT_EQ(3u, index.lower_bound(probes[2]));
+}
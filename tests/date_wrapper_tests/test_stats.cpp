@@ -0,0 +1,156 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/stats.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<std::chrono::milliseconds> make_durations(std::size_t count)
+{
+    std::mt19937_64 gen{7};
+    std::lognormal_distribution<double> millis{8.0, 2.0};
+    std::vector<std::chrono::milliseconds> durations;
+    durations.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        durations.emplace_back(static_cast<long long>(millis(gen)) + 1);
+    return durations;
+}
+
+} // namespace
+
+TEST(DurationStats, tracks_count_sum_min_max_and_mean)
+{
+    DurationStats stats;
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+
+    stats.add(2s);
+    stats.add(DateTimeRange{start, start + 500ms});
+    stats.add(0ms);
+    stats.add(-1500ms);
+
+    EXPECT_EQ(4u, stats.count());
+    EXPECT_DOUBLE_EQ(1.0, stats.sum().count());
+    EXPECT_EQ(-1500ms, stats.min());
+    EXPECT_EQ(2s, stats.max());
+    EXPECT_EQ(250ms, stats.mean());
+    EXPECT_EQ(-1500ms, stats.quantile(0));
+    EXPECT_EQ(0ms, stats.quantile(0.34));
+    EXPECT_EQ(2s, stats.quantile(1));
+}
+
+TEST(DurationStats, is_zero_when_empty)
+{
+    const DurationStats stats;
+
+    EXPECT_EQ(0u, stats.count());
+    EXPECT_EQ(0ns, stats.mean());
+    EXPECT_EQ(0ns, stats.quantile(0.5));
+    EXPECT_THROW(stats.quantile(1.5), std::invalid_argument);
+    EXPECT_THROW(DurationStats{0.0}, std::invalid_argument);
+}
+
+TEST(DurationStats, quantiles_are_within_relative_accuracy)
+{
+    auto durations = make_durations(100'000);
+    DurationStats stats{0.01};
+    for (const auto& duration : durations)
+        stats.add(duration);
+    std::sort(durations.begin(), durations.end());
+
+    for (const double q : {0.01, 0.25, 0.5, 0.9, 0.99, 0.999}) {
+        const auto exact = std::chrono::duration<double>{
+            durations[static_cast<std::size_t>(
+                q * static_cast<double>(durations.size() - 1))]};
+        const auto estimate
+            = std::chrono::duration<double>{stats.quantile(q)};
+        EXPECT_NEAR(exact.count(), estimate.count(), 0.01 * exact.count())
+            << q;
+    }
+}
+
+TEST(DurationStats, merge_equals_single_accumulator)
+{
+    const auto durations = make_durations(10'000);
+    DurationStats all;
+    DurationStats first_half;
+    DurationStats second_half;
+    for (std::size_t i = 0; i < durations.size(); ++i) {
+        all.add(durations[i]);
+        (i < durations.size() / 2 ? first_half : second_half)
+            .add(durations[i]);
+    }
+
+    first_half.merge(second_half);
+
+    EXPECT_EQ(all.count(), first_half.count());
+    EXPECT_EQ(all.min(), first_half.min());
+    EXPECT_EQ(all.max(), first_half.max());
+    EXPECT_EQ(all.mean(), first_half.mean());
+    EXPECT_EQ(all.quantile(0.5), first_half.quantile(0.5));
+    EXPECT_EQ(all.serialize(), first_half.serialize());
+    EXPECT_THROW(first_half.merge(DurationStats{0.02}), std::invalid_argument);
+}
+
+TEST(DurationStats, round_trips_through_serialization)
+{
+    DurationStats stats{0.005};
+    for (const auto& duration : make_durations(1000))
+        stats.add(duration);
+    stats.add(-3s);
+    stats.add(0s);
+
+    const std::string bytes = stats.serialize();
+    const auto restored = DurationStats::deserialize(bytes);
+
+    EXPECT_EQ(0.005, restored.relative_accuracy());
+    EXPECT_EQ(stats.count(), restored.count());
+    EXPECT_EQ(stats.sum(), restored.sum());
+    EXPECT_EQ(stats.min(), restored.min());
+    EXPECT_EQ(stats.quantile(0.75), restored.quantile(0.75));
+    EXPECT_EQ(bytes, restored.serialize());
+    EXPECT_THROW(DurationStats::deserialize(bytes.substr(0, bytes.size() - 1)),
+                 std::invalid_argument);
+    EXPECT_THROW(DurationStats::deserialize("DWS2"), std::invalid_argument);
+}
+
+TEST(DurationStats, accumulates_ranges_on_threads)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    std::vector<DateTimeRange> ranges;
+    for (int i = 0; i < 20'000; ++i)
+        ranges.emplace_back(start, start + std::chrono::seconds{i % 100 + 1});
+
+    const auto parallel = make_duration_stats(ranges, 0.01, 4);
+    const auto serial = make_duration_stats(ranges, 0.01, 1);
+
+    EXPECT_EQ(20'000u, parallel.count());
+    EXPECT_EQ(1s, parallel.min());
+    EXPECT_EQ(100s, parallel.max());
+    EXPECT_EQ(serial.serialize(), parallel.serialize());
+}
@@ -0,0 +1,107 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/date_wrapper.h>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+static_assert(sizeof(TimeOfDay) == 4, "TimeOfDay must take 4 bytes");
+
+TEST(TimeOfDay, splits_time_into_fields)
+{
+    constexpr TimeOfDay time{13h, 5min, 9s, 250ms};
+
+    static_assert(time.hour() == 13h, "");
+    EXPECT_EQ(5min, time.minute());
+    EXPECT_EQ(9s, time.second());
+    EXPECT_EQ(250ms, time.millisecond());
+    EXPECT_EQ(13h + 5min + 9s + 250ms, time.since_midnight());
+    EXPECT_EQ(TimeOfDay{}, TimeOfDay{24h});
+}
+
+TEST(TimeOfDay, arithmetic_wraps_around_midnight)
+{
+    const TimeOfDay time{23h, 30min};
+
+    EXPECT_EQ((TimeOfDay{0h, 30min}), time + 1h);
+    EXPECT_EQ((TimeOfDay{22h, 30min}), time - 1h);
+    EXPECT_EQ((TimeOfDay{23h, 30min}), (TimeOfDay{0h, 30min}) - 1h);
+    EXPECT_EQ(time, time + 24h * 1000);
+    EXPECT_EQ((TimeOfDay{0h, 0min, 0s, 999ms}), TimeOfDay{-1ms + 1s});
+    EXPECT_EQ(2h, (TimeOfDay{1h, 0min}) - (TimeOfDay{23h, 0min}));
+    EXPECT_EQ(22h, (TimeOfDay{23h, 0min}) - (TimeOfDay{1h, 0min}));
+}
+
+TEST(TimeOfDay, compares_by_time_since_midnight)
+{
+    const TimeOfDay morning{8h, 0min};
+    const TimeOfDay evening{20h, 0min};
+
+    EXPECT_LT(morning, evening);
+    EXPECT_LE(morning, morning);
+    EXPECT_GT(evening, morning);
+    EXPECT_NE(morning, evening);
+}
+
+TEST(TimeOfDay, composes_with_date)
+{
+    const Date date{Year{2019}, Month{5}, Day{10}};
+    const TimeOfDay time{9h, 15min, 30s, 500ms};
+
+    const DateTime dt{date + time};
+
+    EXPECT_EQ((DateTime{date, 9h + 15min + 30s + 500ms}), dt);
+    EXPECT_EQ(time, TimeOfDay{dt});
+}
+
+TEST(TimeOfDay, formats_time_expressions)
+{
+    const TimeOfDay time{7h, 5min, 3s, 42ms};
+
+    EXPECT_EQ("07:05:03.042", to_string(time, "hh:mm:ss.zzz"));
+    EXPECT_EQ("7:5:3", to_string(time, "h:m:s"));
+    EXPECT_EQ("yyyy 7 AM", to_string(time, "yyyy h AP"));
+    EXPECT_EQ("7:05 pm", to_string(time + 12h, "h:mm ap"));
+    const CompiledFormat format{"hh:mm", FormatKind::Time};
+    EXPECT_EQ("19:05", format.format(time + 12h));
+}
+
+TEST(TimeOfDay, parses_compiled_format)
+{
+    const CompiledFormat iso{"hh:mm:ss.zzz", FormatKind::Time};
+    const CompiledFormat short_format{"h:mm AP", FormatKind::Time};
+
+    EXPECT_EQ((TimeOfDay{7h, 5min, 3s, 42ms}),
+              iso.parse_time_of_day("07:05:03.042"));
+    EXPECT_EQ((TimeOfDay{19h, 5min}), short_format.parse_time_of_day("7:05 pm"));
+    EXPECT_EQ((TimeOfDay{0h, 30min}),
+              short_format.parse_time_of_day("12:30 AM"));
+    EXPECT_THROW(iso.parse_time_of_day("7:05:03.042"), std::invalid_argument);
+    EXPECT_THROW(iso.parse_time_of_day("24:00:00.000"), std::invalid_argument);
+    EXPECT_THROW(iso.parse_time_of_day("07:05:03.042Z"),
+                 std::invalid_argument);
+    EXPECT_THROW(short_format.parse_time_of_day("13:00 PM"),
+                 std::invalid_argument);
+    EXPECT_THROW(CompiledFormat{"yyyy hh"}.parse_time_of_day("2019 10"),
+                 std::invalid_argument);
+}
@@ -0,0 +1,73 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/tsc_clock.h>
+
+#include <stdexcept>
+#include <thread>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+TEST(TscClock, stays_close_to_system_clock)
+{
+    // Short interval makes the test cover several recalibrations
+    TscClock clock{50ms};
+    for (int i = 0; i < 40; ++i) {
+        const auto before = std::chrono::system_clock::now();
+        const auto now = clock.now();
+        const auto after = std::chrono::system_clock::now();
+        EXPECT_GE(now, before - 1ms);
+        EXPECT_LE(now, after + 1ms);
+        std::this_thread::sleep_for(5ms);
+    }
+}
+
+TEST(TscClock, is_consistent_across_threads)
+{
+    TscClock clock{10ms};
+    auto check = [&clock] {
+        for (int i = 0; i < 2000; ++i) {
+            const auto before = std::chrono::system_clock::now();
+            const auto now = clock.now();
+            EXPECT_GE(now, before - 1ms);
+        }
+    };
+    std::thread other{check};
+    check();
+    other.join();
+}
+
+TEST(TscClock, returns_current_date_time)
+{
+    TscClock clock;
+    const DateTime before{current_date_time()};
+    const DateTime now{current_date_time(clock)};
+    EXPECT_LE(before, now + 1ms);
+    EXPECT_LE(now, before + 1s);
+}
+
+TEST(TscClock, throws_on_invalid_recalibration_interval)
+{
+    EXPECT_THROW(TscClock{0s}, std::invalid_argument);
+    EXPECT_THROW(TscClock{3s}, std::invalid_argument);
+}
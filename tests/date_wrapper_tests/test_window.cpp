@@ -0,0 +1,136 @@
+/********************************************************************************
+**
+** Copyright (C) 2016 - 2019 Pavel Pavlov.
+**
+**
+** This file is part of DateWrapper.
+**
+** DateWrapper is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** DateWrapper is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with DateWrapper.  If not, see <http://www.gnu.org/licenses/>.
+**
+*********************************************************************************/
+#include "gtest/gtest.h"
+#include <date_wrapper/window.h>
+
+#include <vector>
+
+using namespace dw;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<Window> drain_all(WindowAssigner& assigner)
+{
+    std::vector<Window> windows;
+    assigner.drain([&](const Window& window) { windows.push_back(window); });
+    return windows;
+}
+
+} // namespace
+
+TEST(WindowAssigner, tumbling_windows_close_as_stream_advances)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    auto assigner = make_tumbling_windows(10min);
+
+    assigner.add(start + 1min);
+    assigner.add(start + 9min);
+    assigner.add(start + 12min);
+    const auto closed = drain_all(assigner);
+
+    ASSERT_EQ(1u, closed.size());
+    EXPECT_EQ((DateTimeRange{start, start + 10min}), closed[0].range);
+    EXPECT_EQ(2u, closed[0].events);
+    EXPECT_EQ(1u, assigner.open_windows());
+
+    assigner.advance_to(start + 20min);
+    const auto idle = drain_all(assigner);
+    ASSERT_EQ(1u, idle.size());
+    EXPECT_EQ(1u, idle[0].events);
+    EXPECT_EQ(0u, assigner.open_windows());
+}
+
+TEST(WindowAssigner, calendar_tumbling_windows_follow_months)
+{
+    auto assigner = make_tumbling_windows(BucketUnit::Month);
+
+    assigner.add(DateTime{Date{Year{2019}, Month{2}, Day{27}}} + 5h);
+    assigner.add(DateTime{Date{Year{2019}, Month{3}, Day{1}}});
+    assigner.flush();
+    const auto closed = drain_all(assigner);
+
+    ASSERT_EQ(2u, closed.size());
+    EXPECT_EQ((DateTimeRange{DateTime{Date{Year{2019}, Month{2}, Day{1}}},
+                             DateTime{Date{Year{2019}, Month{3}, Day{1}}}}),
+              closed[0].range);
+    EXPECT_EQ(1u, closed[1].events);
+}
+
+TEST(WindowAssigner, sliding_windows_overlap)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    auto assigner = make_sliding_windows(30min, 10min);
+
+    assigner.add(start + 25min);
+    EXPECT_EQ(3u, assigner.open_windows());
+    assigner.add(start + 35min);
+    EXPECT_EQ(3u, assigner.open_windows());
+    assigner.flush();
+    const auto closed = drain_all(assigner);
+
+    ASSERT_EQ(4u, closed.size());
+    EXPECT_EQ((DateTimeRange{start, start + 30min}), closed[0].range);
+    EXPECT_EQ(1u, closed[0].events);
+    EXPECT_EQ(2u, closed[1].events);
+    EXPECT_EQ(2u, closed[2].events);
+    EXPECT_EQ((DateTimeRange{start + 30min, start + 60min}), closed[3].range);
+    EXPECT_EQ(1u, closed[3].events);
+}
+
+TEST(WindowAssigner, iso_week_windows_slide_by_day)
+{
+    const DateTime sunday{Date{Year{2019}, Month{5}, Day{5}}};
+    auto assigner = make_sliding_windows(BucketUnit::IsoWeek, BucketUnit::Day);
+
+    assigner.add(sunday + 12h);
+
+    EXPECT_EQ(7u, assigner.open_windows());
+}
+
+TEST(WindowAssigner, session_windows_split_on_gap)
+{
+    const DateTime start{Date{Year{2019}, Month{5}, Day{1}}};
+    auto assigner = make_session_windows(5min);
+
+    assigner.add(start);
+    assigner.add(start + 3min);
+    assigner.add(start + 7min);
+    assigner.add(start + 13min);
+    assigner.add(start + 12min);
+    assigner.add(start + 1min);
+    assigner.flush();
+    const auto closed = drain_all(assigner);
+
+    ASSERT_EQ(2u, closed.size());
+    EXPECT_EQ((DateTimeRange{start, start + 12min}), closed[0].range);
+    EXPECT_EQ(3u, closed[0].events);
+    EXPECT_EQ((DateTimeRange{start + 13min, start + 18min}), closed[1].range);
+    EXPECT_EQ(1u, closed[1].events);
+    EXPECT_EQ(2u, assigner.dropped());
+}
+
+TEST(WindowAssigner, rejects_invalid_lengths)
+{
+    EXPECT_THROW(make_tumbling_windows(0s), std::invalid_argument);
+    EXPECT_THROW(make_sliding_windows(1h, -1min), std::invalid_argument);
+}